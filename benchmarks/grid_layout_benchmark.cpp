@@ -0,0 +1,174 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "grid.hpp"
+#include "heap_counter.hpp"
+#include "maze_walls.hpp"
+#include "random.hpp"
+
+// Depth-first carving and breadth-first solving on util::Grid, once per
+// storage layout. Both step to a vertical neighbour about half the time,
+// which in a row-major grid is a whole row away; the tiled and Z-order
+// layouts keep those neighbours within a few cache lines.
+
+namespace maze_walker {
+namespace {
+
+template <typename Layout, typename T>
+using LayoutGrid =
+    util::Grid<T, util::kDynamicExtent, util::kDynamicExtent, Layout>;
+
+// Set on a cell once carving has reached it.
+constexpr WallMask kVisited = 0x10;
+
+struct Cell {
+  int row;
+  int col;
+};
+
+Cell step(Cell from, Direction dir) {
+  switch (dir) {
+    case Direction::North: return {from.row - 1, from.col};
+    case Direction::East: return {from.row, from.col + 1};
+    case Direction::South: return {from.row + 1, from.col};
+    case Direction::West: return {from.row, from.col - 1};
+  }
+  return from;
+}
+
+Direction opposite(Direction dir) {
+  return static_cast<Direction>((static_cast<unsigned>(dir) + 2) % 4);
+}
+
+// The recursive backtracker, with the walls and the visited flag of every
+// cell in one grid.
+template <typename Layout>
+LayoutGrid<Layout, WallMask> carve(int side, std::uint64_t seed) {
+  auto maze = LayoutGrid<Layout, WallMask>::Make(side, side, 0xf).value();
+  util::Xoshiro256 rng{seed};
+  std::vector<Cell> stack;
+  stack.reserve(static_cast<std::size_t>(side) *
+                static_cast<std::size_t>(side));
+  stack.push_back({0, 0});
+  maze.at(maze.MakeLocation(0, 0).value()) |= kVisited;
+
+  while (not stack.empty()) {
+    const Cell current = stack.back();
+    Direction candidates[4];
+    std::uint32_t num_candidates = 0;
+    for (const Direction dir : {Direction::North, Direction::East,
+                                Direction::South, Direction::West}) {
+      const Cell next = step(current, dir);
+      const auto location = maze.MakeLocation(next.row, next.col);
+      if (location && not(maze.at(location.value()) & kVisited)) {
+        candidates[num_candidates++] = dir;
+      }
+    }
+    if (num_candidates == 0) {
+      stack.pop_back();
+      continue;
+    }
+
+    const Direction dir = candidates[rng.below(num_candidates)];
+    const Cell next = step(current, dir);
+    maze.at(maze.MakeLocation(current.row, current.col).value()) &=
+        static_cast<WallMask>(~WallBit(dir));
+    WallMask& reached = maze.at(maze.MakeLocation(next.row, next.col).value());
+    reached = static_cast<WallMask>((reached & ~WallBit(opposite(dir))) |
+                                    kVisited);
+    stack.push_back(next);
+  }
+  return maze;
+}
+
+// Distances from the top-left cell to every other cell.
+template <typename Layout>
+LayoutGrid<Layout, std::uint32_t> solve(
+    const LayoutGrid<Layout, WallMask>& maze) {
+  auto distance = LayoutGrid<Layout, std::uint32_t>::Make(
+                      maze.num_rows(), maze.num_cols(), UINT32_MAX)
+                      .value();
+  std::vector<Cell> queue;
+  queue.reserve(distance.size());
+  queue.push_back({0, 0});
+  distance.at(distance.MakeLocation(0, 0).value()) = 0;
+
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const Cell current = queue[head];
+    const auto here = maze.MakeLocation(current.row, current.col).value();
+    const std::uint32_t next_distance =
+        distance.at(distance.MakeLocation(current.row, current.col).value()) +
+        1;
+    for (const Direction dir : {Direction::North, Direction::East,
+                                Direction::South, Direction::West}) {
+      if (maze.at(here) & WallBit(dir)) continue;
+      const Cell next = step(current, dir);
+      auto& seen =
+          distance.at(distance.MakeLocation(next.row, next.col).value());
+      if (seen != UINT32_MAX) continue;
+      seen = next_distance;
+      queue.push_back(next);
+    }
+  }
+  return distance;
+}
+
+template <typename Layout>
+void BM_GridCarve(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto maze = carve<Layout>(side, 7);
+    benchmark::DoNotOptimize(maze);
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK_TEMPLATE(BM_GridCarve, util::RowMajorLayout)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridCarve, util::TiledLayout<8>)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridCarve, util::TiledLayout<16>)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridCarve, util::MortonLayout)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+template <typename Layout>
+void BM_GridSolve(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto maze = carve<Layout>(side, 7);
+  for (auto _ : state) {
+    auto distance = solve<Layout>(maze);
+    benchmark::DoNotOptimize(distance);
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK_TEMPLATE(BM_GridSolve, util::RowMajorLayout)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridSolve, util::TiledLayout<8>)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridSolve, util::TiledLayout<16>)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_GridSolve, util::MortonLayout)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace maze_walker
+
+BENCHMARK_MAIN();
@@ -0,0 +1,60 @@
+#include "heap_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Every block starts with its size, so that operator delete can subtract it;
+// the header keeps the returned pointer at the default new alignment.
+constexpr std::size_t kHeader = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+std::atomic<std::size_t> heap_in_use{0};
+std::atomic<std::size_t> heap_allocated{0};
+std::atomic<std::size_t> heap_allocations{0};
+std::atomic<std::size_t> heap_peak{0};
+
+void* allocate(std::size_t size) {
+  void* block = std::malloc(size + kHeader);
+  if (block == nullptr) throw std::bad_alloc{};
+  *static_cast<std::size_t*>(block) = size;
+
+  heap_allocated.fetch_add(size, std::memory_order_relaxed);
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t in_use =
+      heap_in_use.fetch_add(size, std::memory_order_relaxed) + size;
+  std::size_t peak = heap_peak.load(std::memory_order_relaxed);
+  while (in_use > peak &&
+         not heap_peak.compare_exchange_weak(peak, in_use,
+                                             std::memory_order_relaxed)) {
+  }
+  return static_cast<unsigned char*>(block) + kHeader;
+}
+
+void deallocate(void* ptr) {
+  if (ptr == nullptr) return;
+  void* block = static_cast<unsigned char*>(ptr) - kHeader;
+  heap_in_use.fetch_sub(*static_cast<std::size_t*>(block),
+                        std::memory_order_relaxed);
+  std::free(block);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { deallocate(ptr); }
+
+namespace maze_walker {
+
+std::size_t HeapInUseBytes() { return heap_in_use.load(); }
+std::size_t HeapAllocatedBytes() { return heap_allocated.load(); }
+std::size_t HeapAllocationCount() { return heap_allocations.load(); }
+std::size_t HeapPeakBytes() { return heap_peak.load(); }
+void ResetHeapPeak() { heap_peak.store(heap_in_use.load()); }
+
+}  // namespace maze_walker
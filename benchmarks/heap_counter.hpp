@@ -0,0 +1,53 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace maze_walker {
+
+// Heap use of the benchmark process, counted by the replacement operator new
+// and operator delete in heap_counter.cpp. Allocations made with an extended
+// alignment go through the library and are not counted.
+std::size_t HeapInUseBytes();
+std::size_t HeapAllocatedBytes();  // ever allocated, never decreases
+std::size_t HeapAllocationCount();  // calls to operator new so far
+std::size_t HeapPeakBytes();
+void ResetHeapPeak();
+
+// Peak heap growth while `run` executes, in bytes.
+template <typename Run>
+double PeakHeapBytes(Run&& run) {
+  const std::size_t base = HeapInUseBytes();
+  ResetHeapPeak();
+  run();
+  return static_cast<double>(HeapPeakBytes() - base);
+}
+
+// Bytes allocated and calls to operator new between construction and
+// Report(), reported per iteration as "alloc B/iter" and "allocs/iter".
+// Construct it right before the benchmark loop.
+class AllocationMeter {
+  std::size_t start_ = HeapAllocatedBytes();
+  std::size_t start_count_ = HeapAllocationCount();
+
+ public:
+  void Report(benchmark::State& state) const {
+    state.counters["alloc B/iter"] =
+        benchmark::Counter(static_cast<double>(HeapAllocatedBytes() - start_),
+                           benchmark::Counter::kAvgIterations);
+    state.counters["allocs/iter"] = benchmark::Counter(
+        static_cast<double>(HeapAllocationCount() - start_count_),
+        benchmark::Counter::kAvgIterations);
+  }
+};
+
+// Sets "cells/s" from the cells handled by one iteration.
+inline void SetCellsPerSecond(benchmark::State& state,
+                              double cells_per_iteration) {
+  state.counters["cells/s"] = benchmark::Counter(
+      cells_per_iteration * static_cast<double>(state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,456 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "heap_counter.hpp"
+#include "maze_flood.hpp"
+#include "maze_packed.hpp"
+#include "maze_solver.hpp"
+#include "maze_validate.hpp"
+#include "mazegen_eller.hpp"
+#include "mazegen_growing_tree.hpp"
+#include "mazegen_spanning_tree.hpp"
+#include "mazegen_tiled.hpp"
+#include "square_rectangular_maze.hpp"
+
+namespace maze_walker {
+namespace {
+
+void BM_GenerateMaze(benchmark::State& state, SelectionStrategy strategy) {
+  const auto side = static_cast<int>(state.range(0));
+  GrowingTreeOptions options;
+  options.strategy = strategy;
+  const AllocationMeter allocations;
+  for (auto _ : state) {
+    auto maze = GenerateMaze(side, side, options);
+    benchmark::DoNotOptimize(maze);
+  }
+
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+  allocations.Report(state);
+}
+BENCHMARK_CAPTURE(BM_GenerateMaze, newest, SelectionStrategy::Newest)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GenerateMaze, oldest, SelectionStrategy::Oldest)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GenerateMaze, random, SelectionStrategy::Random)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GenerateMaze, mixed, SelectionStrategy::Mixed)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+outcome::result<WallPlanes> GrowingTreeWalls(int side,
+                                             SelectionStrategy strategy) {
+  GrowingTreeOptions options;
+  options.strategy = strategy;
+  GrowingTreeGenerator generator =
+      OUTCOME_TRYX(GrowingTreeGenerator::Make(side, side, options));
+  while (generator.Next()) {
+  }
+  return generator.walls();
+}
+
+// Single-threaded generators side by side, on wall planes so that the proto
+// conversion does not dominate. "peak B/cell" is the heap high-water mark of
+// one extra, untimed run.
+template <typename Generate>
+void BM_GenerateWalls(benchmark::State& state, Generate generate) {
+  const auto side = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto walls = generate(side);
+    benchmark::DoNotOptimize(walls);
+  }
+
+  const auto cells = static_cast<double>(side) * static_cast<double>(side);
+  SetCellsPerSecond(state, cells);
+  state.counters["peak B/cell"] =
+      PeakHeapBytes([&] { benchmark::DoNotOptimize(generate(side)); }) /
+      cells;
+}
+BENCHMARK_CAPTURE(BM_GenerateWalls, growing_tree_newest, [](int side) {
+  return GrowingTreeWalls(side, SelectionStrategy::Newest);
+})->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GenerateWalls, growing_tree_random, [](int side) {
+  return GrowingTreeWalls(side, SelectionStrategy::Random);
+})->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GenerateWalls, kruskal, [](int side) {
+  return GenerateKruskalWalls(side, side);
+})->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GenerateWalls, wilson, [](int side) {
+  return GenerateWilsonWalls(side, side);
+})->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+
+// Wall planes only, so that the proto conversion does not hide the scaling.
+void BM_GenerateTiledWalls(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  TiledOptions options;
+  options.threads = static_cast<unsigned>(state.range(1));
+  for (auto _ : state) {
+    auto walls = GenerateTiledWalls(side, side, options);
+    benchmark::DoNotOptimize(walls);
+  }
+
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK(BM_GenerateTiledWalls)
+    ->ArgNames({"side", "threads"})
+    ->Args({4096, 1})
+    ->Args({4096, 2})
+    ->Args({4096, 4})
+    ->Args({4096, 8})
+    ->Args({4096, 16})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Rows are consumed and dropped, so memory stays O(width) however many rows
+// are streamed.
+void BM_GenerateMazeRows(benchmark::State& state) {
+  const auto width = static_cast<int>(state.range(0));
+  const std::int64_t rows = 1024;
+  for (auto _ : state) {
+    auto streamed = GenerateMazeRows(
+        width, rows, {},
+        [](std::span<const WallMask> row) -> outcome::result<void> {
+          benchmark::DoNotOptimize(row.data());
+          return outcome::success();
+        });
+    benchmark::DoNotOptimize(streamed);
+  }
+
+  SetCellsPerSecond(state,
+                    static_cast<double>(width) * static_cast<double>(rows));
+}
+BENCHMARK(BM_GenerateMazeRows)
+    ->RangeMultiplier(4)
+    ->Range(16, 16384)
+    ->Unit(benchmark::kMillisecond);
+
+// The NESW masks of every cell from the bit planes: one CellWalls call per
+// cell against the row kernels.
+enum class MaskKernel {
+  CellWalls,
+  Portable,
+  Row,
+};
+
+void BM_WallMasks(benchmark::State& state, MaskKernel kernel) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto walls = GenerateTiledWalls(side, side, {}).value();
+  std::vector<WallMask> masks(static_cast<std::size_t>(side));
+  for (auto _ : state) {
+    for (int row = 0; row < side; ++row) {
+      switch (kernel) {
+        case MaskKernel::CellWalls:
+          for (int col = 0; col < side; ++col) {
+            masks[static_cast<std::size_t>(col)] = CellWalls(walls, row, col);
+          }
+          break;
+        case MaskKernel::Portable:
+          RowWallsPortable(walls, row, masks);
+          break;
+        case MaskKernel::Row:
+          RowWalls(walls, row, masks);
+          break;
+      }
+      benchmark::DoNotOptimize(masks.data());
+      benchmark::ClobberMemory();
+    }
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK_CAPTURE(BM_WallMasks, cell_walls, MaskKernel::CellWalls)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_WallMasks, portable, MaskKernel::Portable)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_WallMasks, row, MaskKernel::Row)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+// Where ToMazeData puts the message: a new one per call, one message reused
+// across calls, or a new one on a protobuf arena per call.
+enum class MessageTarget {
+  Fresh,
+  Reused,
+  Arena,
+};
+
+// Conversions between the bit planes the generators work on and the proto.
+void BM_ToMazeData(benchmark::State& state, WallEncoding encoding,
+                   MessageTarget target) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto walls = GenerateTiledWalls(side, side, {}).value();
+  SquareRectangularMazeData reused;
+  const AllocationMeter allocations;
+  for (auto _ : state) {
+    switch (target) {
+      case MessageTarget::Fresh: {
+        auto data = ToMazeData(walls, encoding);
+        benchmark::DoNotOptimize(data);
+        break;
+      }
+      case MessageTarget::Reused:
+        benchmark::DoNotOptimize(ToMazeData(walls, reused, encoding));
+        break;
+      case MessageTarget::Arena: {
+        google::protobuf::Arena arena;
+        benchmark::DoNotOptimize(ToMazeData(walls, arena, encoding));
+        break;
+      }
+    }
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+  allocations.Report(state);
+}
+BENCHMARK_CAPTURE(BM_ToMazeData, repeated, WallEncoding::Repeated,
+                  MessageTarget::Fresh)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ToMazeData, repeated_reused, WallEncoding::Repeated,
+                  MessageTarget::Reused)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ToMazeData, repeated_arena, WallEncoding::Repeated,
+                  MessageTarget::Arena)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ToMazeData, packed, WallEncoding::Packed,
+                  MessageTarget::Fresh)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ToMazeData, packed_reused, WallEncoding::Packed,
+                  MessageTarget::Reused)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_FromMazeData(benchmark::State& state, WallEncoding encoding) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto data =
+      ToMazeData(GenerateTiledWalls(side, side, {}).value(), encoding).value();
+  const AllocationMeter allocations;
+  for (auto _ : state) {
+    auto walls = FromMazeData(data);
+    benchmark::DoNotOptimize(walls);
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+  allocations.Report(state);
+}
+BENCHMARK_CAPTURE(BM_FromMazeData, repeated, WallEncoding::Repeated)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_FromMazeData, packed, WallEncoding::Packed)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SerializeMazeData(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto data = GenerateMazeTiled(side, side).value();
+  const AllocationMeter allocations;
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    const std::string serialized = data.SerializeAsString();
+    bytes = serialized.size();
+    benchmark::DoNotOptimize(serialized.data());
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+  allocations.Report(state);
+  state.SetBytesProcessed(static_cast<std::int64_t>(bytes) *
+                          state.iterations());
+}
+BENCHMARK(BM_SerializeMazeData)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+// Loading a stored maze: parsing the proto against mapping the packed file.
+void BM_ParseMazeData(benchmark::State& state, WallEncoding encoding) {
+  const auto side = static_cast<int>(state.range(0));
+  const std::string serialized =
+      ToMazeData(GenerateTiledWalls(side, side, {}).value(), encoding)
+          .value()
+          .SerializeAsString();
+  const AllocationMeter allocations;
+  for (auto _ : state) {
+    SquareRectangularMazeData data;
+    benchmark::DoNotOptimize(data.ParseFromString(serialized));
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+  allocations.Report(state);
+  state.SetBytesProcessed(static_cast<std::int64_t>(serialized.size()) *
+                          state.iterations());
+}
+BENCHMARK_CAPTURE(BM_ParseMazeData, repeated, WallEncoding::Repeated)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseMazeData, packed, WallEncoding::Packed)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+// Reading every cell through SquareRectangularMaze::walls(), the way the
+// renderer and the solver graph take a maze in.
+void BM_MazeWallsLookup(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto maze =
+      SquareRectangularMaze::Make(GenerateMazeTiled(side, side).value())
+          .value();
+  for (auto _ : state) {
+    std::size_t standing = 0;
+    for (int row = 0; row < side; ++row) {
+      for (int col = 0; col < side; ++col) {
+        standing += maze.walls(maze.make_position(row, col).value()).count();
+      }
+    }
+    benchmark::DoNotOptimize(standing);
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK(BM_MazeWallsLookup)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_OpenPackedMaze(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto path =
+      std::filesystem::temp_directory_path() / "mazegen_benchmark.mzpk";
+  const auto walls = GenerateTiledWalls(side, side, {}).value();
+  if (not PackedMaze::Make(walls).value().Save(path)) {
+    state.SkipWithError("cannot write the packed maze");
+    return;
+  }
+
+  for (auto _ : state) {
+    const PackedMaze maze = PackedMaze::Open(path).value();
+    const auto pos = maze.make_position(side / 2, side / 2).value();
+    benchmark::DoNotOptimize(maze.walls(pos));
+  }
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_OpenPackedMaze)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+
+// Corner to corner, on a graph and solver built once per maze size.
+void BM_SolveMaze(benchmark::State& state, SolverAlgorithm algorithm) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto walls = GenerateTiledWalls(side, side, {}).value();
+  const auto graph = MazeGraph::Make(walls).value();
+  MazeSolver solver = MazeSolver::Make(graph).value();
+
+  for (auto _ : state) {
+    auto path = solver.Solve({0, 0}, {side - 1, side - 1}, algorithm);
+    benchmark::DoNotOptimize(path);
+  }
+
+  state.counters["solves/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  state.counters["expanded"] = static_cast<double>(solver.expanded());
+}
+BENCHMARK_CAPTURE(BM_SolveMaze, bfs, SolverAlgorithm::Bfs)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(4000)
+    ->Arg(8000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SolveMaze, a_star, SolverAlgorithm::AStar)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(4000)
+    ->Arg(8000)
+    ->Unit(benchmark::kMillisecond);
+
+// Whole-maze flood from a corner; compare cells/s with the BFS expansions of
+// BM_SolveMaze/bfs. Newest-cell mazes keep the frontier to a few cells per
+// word, random-cell mazes fill the words.
+void BM_FloodFill(benchmark::State& state, bool with_distances) {
+  const auto side = static_cast<int>(state.range(0));
+  TiledOptions options;
+  options.growing_tree.strategy = state.range(1) == 0
+                                      ? SelectionStrategy::Newest
+                                      : SelectionStrategy::Random;
+  FloodFill flood =
+      FloodFill::Make(GenerateTiledWalls(side, side, options).value())
+          .value();
+  std::vector<std::uint32_t> distances;
+
+  for (auto _ : state) {
+    auto stats = with_distances ? flood.Run({0, 0}, distances)
+                                : flood.Run({0, 0});
+    benchmark::DoNotOptimize(stats);
+  }
+
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK_CAPTURE(BM_FloodFill, eccentricity, false)
+    ->ArgNames({"side", "random"})
+    ->Args({1000, 0})
+    ->Args({8000, 0})
+    ->Args({1000, 1})
+    ->Args({8000, 1})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_FloodFill, distances, true)
+    ->ArgNames({"side", "random"})
+    ->Args({1000, 0})
+    ->Args({8000, 0})
+    ->Args({1000, 1})
+    ->Args({8000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// Perfect-maze validation as done on ingest. The proto form needs about 40
+// bytes per cell, so it stops at 4M cells; the bit planes go up to 100M.
+void BM_ValidateMazeData(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto data = GenerateMazeTiled(side, side).value();
+  for (auto _ : state) {
+    auto valid = ValidatePerfectMaze(data);
+    benchmark::DoNotOptimize(valid);
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK(BM_ValidateMazeData)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Arg(2048)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_ValidateWallPlanes(benchmark::State& state) {
+  const auto side = static_cast<int>(state.range(0));
+  const auto walls = GenerateTiledWalls(side, side, {}).value();
+  for (auto _ : state) {
+    auto valid = ValidatePerfectMaze(walls);
+    benchmark::DoNotOptimize(valid);
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+}
+BENCHMARK(BM_ValidateWallPlanes)
+    ->Arg(1000)
+    ->Arg(4000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace maze_walker
+
+BENCHMARK_MAIN();
@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+
+#include "heap_counter.hpp"
+#include "maze_renderer.hpp"
+#include "mazegen_tiled.hpp"
+
+namespace maze_walker {
+namespace {
+
+constexpr unsigned kTargetWidth = 1024;
+constexpr unsigned kTargetHeight = 768;
+
+// The offscreen target and the tile texture, shared by every benchmark.
+// sf::RenderTexture brings its own OpenGL context, so no window is opened;
+// without a usable OpenGL driver the benchmarks are skipped.
+struct RenderResources {
+  sf::RenderTexture target;
+  std::unique_ptr<TilesLibrary> tiles;
+};
+
+RenderResources* render_resources() {
+  static const std::unique_ptr<RenderResources> resources =
+      []() -> std::unique_ptr<RenderResources> {
+    auto created = std::make_unique<RenderResources>();
+    if (not created->target.create(kTargetWidth, kTargetHeight)) {
+      return nullptr;
+    }
+    auto tiles = TilesLibrary::Make(MAZE_ASSETS_DIR "/roadTextures.png");
+    if (not tiles) return nullptr;
+    created->tiles = std::make_unique<TilesLibrary>(std::move(tiles).value());
+    return created;
+  }();
+  return resources.get();
+}
+
+// One frame of a maze drawn by MazeRenderer into the offscreen target: the
+// whole maze fitted to the target (the bitmap once cells get too small), or a
+// 1:1 view of its top-left corner (the cached chunks).
+void BM_RenderMaze(benchmark::State& state, bool whole_maze) {
+  RenderResources* resources = render_resources();
+  if (resources == nullptr) {
+    state.SkipWithError("no offscreen OpenGL target");
+    return;
+  }
+
+  const auto side = static_cast<int>(state.range(0));
+  const auto walls = GenerateTiledWalls(side, side, {}).value();
+  const MazeRenderer renderer =
+      MazeRenderer::Make(*resources->tiles, walls).value();
+
+  sf::RenderTexture& target = resources->target;
+  const float extent = renderer.cell_size() * static_cast<float>(side);
+  const sf::Vector2f size{static_cast<float>(kTargetWidth),
+                          static_cast<float>(kTargetHeight)};
+  target.setView(whole_maze ? sf::View{sf::FloatRect{0, 0, extent, extent}}
+                            : sf::View{sf::FloatRect{{0, 0}, size}});
+
+  const AllocationMeter allocations;
+  for (auto _ : state) {
+    target.clear(sf::Color::Black);
+    target.draw(renderer);
+    target.display();
+  }
+
+  const auto& drawn = renderer.last_draw();
+  state.counters["chunks"] = static_cast<double>(drawn.chunks_drawn);
+  state.counters["bitmap"] = drawn.lod ? 1 : 0;
+  state.counters["frames/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  allocations.Report(state);
+}
+BENCHMARK_CAPTURE(BM_RenderMaze, whole_maze, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RenderMaze, corner, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+// Building the renderer: the per-cell wall masks and the bitmap.
+void BM_MakeRenderer(benchmark::State& state) {
+  RenderResources* resources = render_resources();
+  if (resources == nullptr) {
+    state.SkipWithError("no offscreen OpenGL target");
+    return;
+  }
+
+  const auto side = static_cast<int>(state.range(0));
+  const auto walls = GenerateTiledWalls(side, side, {}).value();
+  const AllocationMeter allocations;
+  for (auto _ : state) {
+    auto renderer = MazeRenderer::Make(*resources->tiles, walls);
+    benchmark::DoNotOptimize(renderer);
+  }
+  SetCellsPerSecond(state, static_cast<double>(side) * side);
+  allocations.Report(state);
+}
+BENCHMARK(BM_MakeRenderer)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace maze_walker
+
+BENCHMARK_MAIN();
@@ -1,21 +1,187 @@
-#include <iterator>
-#include <utility>
-#include <fmt/format.h>
+#include <fuzzer/FuzzedDataProvider.h>
 
-[[nodiscard]] auto sum_values(const uint8_t *Data, size_t Size)
-{
-  constexpr auto scale = 1000;
+#include <cstdint>
+#include <cstdlib>
+#include <outcome.hpp>
+#include <span>
 
-  int value = 0;
-  for (std::size_t offset = 0; offset < Size; ++offset) {
-    value += static_cast<int>(*std::next(Data, static_cast<long>(offset))) * scale;
+#include "maze_packed.hpp"
+#include "maze_validate.hpp"
+#include "maze_walls.hpp"
+#include "mazegen_eller.hpp"
+#include "mazegen_growing_tree.hpp"
+#include "mazegen_spanning_tree.hpp"
+#include "mazegen_tiled.hpp"
+#include "square_rectangular_maze.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+// libFuzzer harnesses for the maze pipeline. One input byte picks the
+// harness, the rest is its input. Every check is linear in the maze size and
+// nothing is printed per input, so the fuzzer keeps a high exec/s; a broken
+// invariant aborts, which libFuzzer reports with the offending input.
+
+namespace maze_walker {
+namespace {
+
+// Generated mazes stay small: the invariants do not depend on the size, and
+// small mazes keep the executions fast. Tiles are at least 64 columns wide,
+// so the tiled generator gets wider mazes to have more than one tile column.
+constexpr int kMaxGeneratedSide = 32;
+constexpr int kMaxTiledCols = 3 * 64;
+
+void check(bool invariant) {
+  if (not invariant) std::abort();
+}
+
+enum class Generator : std::uint8_t {
+  GrowingTree,
+  Tiled,
+  Eller,
+  Kruskal,
+  Wilson,
+  kMaxValue = Wilson,
+};
+
+SelectionStrategy pick_strategy(FuzzedDataProvider& input) {
+  constexpr SelectionStrategy kStrategies[] = {
+      SelectionStrategy::Newest, SelectionStrategy::Oldest,
+      SelectionStrategy::Random, SelectionStrategy::Mixed};
+  return input.PickValueInArray(kStrategies);
+}
+
+outcome::result<SquareRectangularMazeData> generate(Generator generator,
+                                                    int cols, int rows,
+                                                    std::uint64_t seed,
+                                                    FuzzedDataProvider& input) {
+  switch (generator) {
+    case Generator::GrowingTree:
+    case Generator::Tiled: {
+      GrowingTreeOptions growing_tree;
+      growing_tree.strategy = pick_strategy(input);
+      growing_tree.random_ratio = input.ConsumeProbability<double>();
+      growing_tree.seed = seed;
+      if (generator == Generator::GrowingTree) {
+        return GenerateMaze(cols, rows, growing_tree);
+      }
+      TiledOptions tiled;
+      tiled.tile_rows = input.ConsumeIntegralInRange(1, kMaxGeneratedSide);
+      tiled.tile_cols = input.ConsumeIntegralInRange(1, kMaxTiledCols);
+      tiled.threads = 1;
+      tiled.growing_tree = growing_tree;
+      return GenerateMazeTiled(cols, rows, tiled);
+    }
+    case Generator::Eller: {
+      EllerOptions options;
+      options.merge_probability = input.ConsumeProbability<double>();
+      options.down_probability = input.ConsumeProbability<double>();
+      options.seed = seed;
+      SquareRectangularMazeData maze;
+      maze.set_num_cols(cols);
+      maze.set_num_rows(rows);
+      OUTCOME_TRYV(GenerateMazeRows(
+          cols, rows, options,
+          [&maze](std::span<const WallMask> row) -> outcome::result<void> {
+            for (const WallMask walls : row) {
+              auto* cell = maze.add_walls();
+              cell->set_n(walls & WallBit(Direction::North));
+              cell->set_e(walls & WallBit(Direction::East));
+              cell->set_s(walls & WallBit(Direction::South));
+              cell->set_w(walls & WallBit(Direction::West));
+            }
+            return outcome::success();
+          }));
+      return maze;
+    }
+    case Generator::Kruskal:
+    case Generator::Wilson: {
+      SpanningTreeOptions options;
+      options.seed = seed;
+      return generator == Generator::Kruskal
+                 ? GenerateMazeKruskal(cols, rows, options)
+                 : GenerateMazeWilson(cols, rows, options);
+    }
   }
-  return value;
+  std::abort();
 }
 
-// Fuzzer that attempts to invoke undefined behavior for signed integer overflow
-extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size)
-{
-  fmt::print("Value sum: {}, len{}\n", sum_values(Data,Size), Size);
+// Every generator, any size and options: the result must be a perfect maze
+// of the requested size.
+void fuzz_generation(FuzzedDataProvider& input) {
+  const auto generator = input.ConsumeEnum<Generator>();
+  const int cols = input.ConsumeIntegralInRange(
+      1, generator == Generator::Tiled ? kMaxTiledCols : kMaxGeneratedSide);
+  const int rows = input.ConsumeIntegralInRange(1, kMaxGeneratedSide);
+  const auto seed = input.ConsumeIntegral<std::uint64_t>();
+
+  const auto maze = generate(generator, cols, rows, seed, input);
+  check(maze.has_value());
+  check(maze.value().num_cols() == cols && maze.value().num_rows() == rows);
+  check(ValidatePerfectMaze(maze.value()).has_value());
+}
+
+// Arbitrary bytes as a serialized maze. Whatever parses must either be
+// rejected with an error or answer wall queries for all of its cells; a
+// maze that passes validation must look the same through every other form.
+void fuzz_parsing(FuzzedDataProvider& input) {
+  const auto validation = input.ConsumeBool() ? MazeValidation::PerfectMaze
+                                              : MazeValidation::Dimensions;
+  const auto bytes = input.ConsumeRemainingBytes<std::uint8_t>();
+  SquareRectangularMazeData data;
+  if (not data.ParseFromArray(bytes.data(), static_cast<int>(bytes.size()))) {
+    return;
+  }
+
+  const bool perfect = ValidatePerfectMaze(data).has_value();
+  const auto planes = FromMazeData(data);
+  const auto maze = SquareRectangularMaze::Make(data, validation);
+  check(maze.has_value() == (validation == MazeValidation::PerfectMaze
+                                 ? perfect
+                                 : planes.has_value()));
+  check(planes.has_value() || not perfect);
+  if (not maze) return;
+
+  const int rows = maze.value().num_rows();
+  const int cols = maze.value().num_cols();
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      const auto walls =
+          maze.value().walls(maze.value().make_position(row, col).value());
+      // The outer boundary is closed whatever the flags say.
+      check(walls[0] || row > 0);
+      check(walls[1] || col < cols - 1);
+      check(walls[2] || row < rows - 1);
+      check(walls[3] || col > 0);
+    }
+  }
+  if (not perfect) return;
+
+  // Only the south and east flags reach the bit planes, so the other forms
+  // agree with the message once its walls are known to be symmetric.
+  check(ValidatePerfectMaze(planes.value()).has_value());
+  const auto packed = PackedMaze::Make(planes.value());
+  check(packed.has_value());
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      const auto walls =
+          maze.value().walls(maze.value().make_position(row, col).value());
+      check(walls.to_ulong() == CellWalls(planes.value(), row, col));
+      check(walls == packed.value().walls(
+                         packed.value().make_position(row, col).value()));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace maze_walker
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size) {
+  FuzzedDataProvider input{data, size};
+  if (input.ConsumeBool()) {
+    maze_walker::fuzz_generation(input);
+  } else {
+    maze_walker::fuzz_parsing(input);
+  }
   return 0;
 }
@@ -9,6 +9,7 @@
 #include <SFML/System/Clock.hpp>
 #include <SFML/Window/Event.hpp>
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <filesystem>
 #include <functional>
@@ -19,9 +20,14 @@
 #include <vector>
 
 #include "grid.hpp"
+#include "maze_renderer.hpp"
+#include "maze_solver.hpp"
+#include "maze_stats.hpp"
+#include "mazegen_growing_tree.hpp"
+#include "mazegen_worker.hpp"
+#include "profile.hpp"
 #include "solarized.hpp"
 #include "square_rectangular_maze.pb.h"
-#include "mazegen_growing_tree.hpp"
 
 namespace outcome = OUTCOME_V2_NAMESPACE;
 namespace fs = std::filesystem;
@@ -51,165 +57,6 @@ outcome::result<Configuration> MakeConfiguration(
   return config;
 }
 
-class SquareRectangularMaze {
-  SquareRectangularMazeData data_;
-
- public:
-  static outcome::result<SquareRectangularMaze> Make(int num_cols,
-                                                     int num_rows) {
-    SquareRectangularMazeData data;
-    data.set_num_cols(num_cols);
-    data.set_num_rows(num_rows);
-
-    for (int i = 0; i < num_cols * num_rows; ++i) {
-      auto wall = data.add_walls();
-      wall->set_n(false);
-      wall->set_e(false);
-      wall->set_s(false);
-      wall->set_w(false);
-    }
-
-    SquareRectangularMaze maze;
-    maze.data_ = std::move(data);
-    return outcome::success(std::move(maze));
-  }
-
-  static outcome::result<SquareRectangularMaze> Make(
-      SquareRectangularMazeData data) {
-    if (data.num_cols() <= 0 || data.num_rows() <= 0) {
-      return outcome::failure(std::errc::invalid_argument);
-    }
-    if (data.walls_size() != data.num_cols() * data.num_rows()) {
-      return outcome::failure(std::errc::invalid_argument);
-    }
-
-    SquareRectangularMaze maze;
-    maze.data_ = std::move(data);
-    return outcome::success(std::move(maze));
-  }
-
-  int num_rows() const { return data_.num_rows(); }
-  int num_cols() const { return data_.num_cols(); }
-
-  class ValidPosition {
-    int row_;
-    int col_;
-
-    ValidPosition(int row, int col) : row_{row}, col_{col} {}
-    friend class SquareRectangularMaze;
-
-   public:
-    int row() const { return row_; }
-    int col() const { return col_; }
-  };
-
-  outcome::result<ValidPosition> make_position(int row, int col) const {
-    if (row < 0 || row >= num_rows()) {
-      return outcome::failure(std::errc::invalid_argument);
-    }
-
-    if (col < 0 || col >= num_cols()) {
-      return outcome::failure(std::errc::invalid_argument);
-    }
-
-    return outcome::success(ValidPosition{row, col});
-  }
-
-  bool has_wall_north(const ValidPosition& pos) const {
-    if (pos.row() == 0) {
-      return true;
-    }
-    return data_.walls(pos2idx(pos)).n();
-  }
-
-  bool has_wall_east(const ValidPosition& pos) const {
-    if (pos.col() == num_cols() - 1) {
-      return true;
-    }
-    return data_.walls(pos2idx(pos)).e();
-  }
-
-  bool has_wall_south(const ValidPosition& pos) const {
-    if (pos.row() == num_rows() - 1) {
-      return true;
-    }
-    return data_.walls(pos2idx(pos)).s();
-  }
-
-  bool has_wall_west(const ValidPosition& pos) const {
-    if (pos.col() == 0) {
-      return true;
-    }
-    return data_.walls(pos2idx(pos)).w();
-  }
-
-  std::bitset<4> walls(const ValidPosition& pos) const {
-    std::bitset<4> walls;
-    walls[0] = has_wall_north(pos);
-    walls[1] = has_wall_east(pos);
-    walls[2] = has_wall_south(pos);
-    walls[3] = has_wall_west(pos);
-    return walls;
-  }
-
- private:
-  int pos2idx(const ValidPosition& pos) const {
-    return num_cols() * pos.row() + pos.col();
-  }
-};
-
-class TilesLibrary {
-  sf::Texture texture_;
-  std::vector<sf::IntRect> base_tiles_;
-
- public:
-  static outcome::result<TilesLibrary> Make(fs::path path_to_texture) {
-    TilesLibrary tl;
-    const int pixel_width = 128;
-    const int pixel_height = 128;
-    tl.texture_.loadFromFile(path_to_texture.string());
-
-    std::vector<std::pair<int, int>> offsets = {
-        {9, 0},  // 0 - all open
-        {5, 3},  // 1 - N
-        {5, 2},  // 2 - E
-        {6, 0},  // 3 - NE
-        {4, 3},  // 4 - S
-        {0, 1},  // 5 - NS
-        {6, 1},  // 6 - SE
-        {9, 3},  // 7 - NES
-        {4, 2},  // 8 - W
-        {5, 0},  // 9 - NW
-        {0, 0},  // 10 - EW
-        {8, 2},  // 11 - NEW
-        {5, 1},  // 12 - SW
-        {8, 3},  // 13 - NSW
-        {9, 2},  // 14 - ESW
-        {0, 2},  // 15 - NESW
-    };
-
-    using VI = sf::Vector2i;
-
-    const auto size = VI{pixel_width, pixel_height};
-
-    tl.base_tiles_.reserve(offsets.size());
-    std::transform(
-        offsets.begin(), offsets.end(), std::back_inserter(tl.base_tiles_),
-        [&](const std::pair<int, int>& offset) {
-          return sf::IntRect{
-              VI{offset.first * pixel_width, offset.second * pixel_height},
-              size};
-        });
-
-    return tl;
-  }
-
-  sf::Texture const* texture() const { return &texture_; }
-  const sf::IntRect& texture_rect_for(std::bitset<4> tile_type) const {
-    return base_tiles_[tile_type.to_ulong()];
-  }
-};
-
 sf::FloatRect ComputeAspectPreservingViewport(const sf::Vector2u& screen_size) {
   if (screen_size.x >= screen_size.y) {
     const float dim_ratio_inv =
@@ -224,29 +71,26 @@ sf::FloatRect ComputeAspectPreservingViewport(const sf::Vector2u& screen_size) {
   return sf::FloatRect{0.0f, top_margin, 1.0f, dim_ratio_inv};
 }
 
-outcome::result<void> Draw(sf::RenderTarget& target, const TilesLibrary& tl,
-                           const SquareRectangularMaze& maze) {
-  const auto side_size = 50.0f;
+// Draws one sf::RectangleShape per cell, the way the maze was drawn before
+// MazeRenderer. Kept to compare frame times from the debug overlay.
+void DrawPerCell(sf::RenderTarget& target, const TilesLibrary& tl,
+                 const MazeRenderer& maze) {
+  const auto side_size = maze.cell_size();
   const auto rect_size = sf::Vector2f{side_size, side_size};
 
   for (int row = 0; row < maze.num_rows(); ++row) {
     for (int col = 0; col < maze.num_cols(); ++col) {
-      const auto maze_position = OUTCOME_TRYX(maze.make_position(row, col));
       sf::RectangleShape rect{rect_size};
       const float shift_x = side_size * static_cast<float>(col);
       const float shift_y = side_size * static_cast<float>(row);
-      const auto world_position = sf::Vector2f{shift_x, shift_y};
-      rect.setPosition(world_position);
+      rect.setPosition(sf::Vector2f{shift_x, shift_y});
 
       rect.setTexture(tl.texture());
-      const auto walls = maze.walls(maze_position);
-      rect.setTextureRect(tl.texture_rect_for(walls));
+      rect.setTextureRect(tl.texture_rect_for(maze.walls(row, col)));
 
       target.draw(rect);
     }
   }
-
-  return outcome::success();
 }
 
 constexpr auto sample_maze = R"proto(
@@ -273,12 +117,27 @@ outcome::result<void> Main(const std::vector<std::string>& args) {
   const TilesLibrary tiles_library =
       OUTCOME_TRYX(TilesLibrary::Make(road_textures_filepath));
 
+  // The maze is carved on a worker thread; the window starts out with every
+  // wall standing and shows the carves as they are taken from the queue.
+  GenerationWorker generator = OUTCOME_TRYX(GenerationWorker::Start(20, 15));
+  WallPlanes walls = OUTCOME_TRYX(
+      WallPlanes::Make(generator.num_rows(), generator.num_cols()));
+  MazeRenderer renderer =
+      OUTCOME_TRYX(MazeRenderer::Make(tiles_library, walls));
+  const auto carve = [&walls, &renderer](const CarveEvent& carved) {
+    walls.Carve(carved);
+    renderer.Carve(carved);
+  };
 
-  std::vector<SquareRectangularMazeData> data = OUTCOME_TRYX(GenerateMazeWithSteps(15, 20));
-  // google::protobuf::TextFormat::ParseFromString(sample_maze, &data);
-  auto display_iter = data.begin();
-  SquareRectangularMaze maze =
-      OUTCOME_TRYX(SquareRectangularMaze::Make(*display_iter));
+  // Solution from the top-left to the bottom-right cell, toggled with S and
+  // recomputed when the maze changed since the last solve.
+  bool show_solution = false;
+  bool solution_stale = true;
+  sf::VertexArray solution;
+  std::size_t solution_length = 0;
+
+  // Quality metrics, computed once the maze is complete.
+  std::optional<MazeStats> maze_stats;
 
   sf::RenderWindow window(sf::VideoMode(1024, 768), "MazeWalker");
   window.setFramerateLimit(60);
@@ -290,12 +149,38 @@ outcome::result<void> Main(const std::vector<std::string>& args) {
 
   sf::FloatRect viewport_debug{};
 
+  // Mouse wheel zooms, arrow keys pan.
+  sf::View view = window.getDefaultView();
+  float zoom = 1.0f;
+  constexpr float zoom_step = 1.25f;
+  constexpr float pan_step = 0.1f;
+
   bool show_overlay = false;
+  bool draw_per_cell = false;
+  bool autoplay = false;
+  constexpr std::size_t carves_per_frame = 1;
+  sf::Time draw_time;
+
+  // CPU time of the most recent frames, from handling the events up to
+  // display(), as a ring buffer for the overlay's plot.
+  constexpr std::size_t frame_history = 120;
+  std::array<float, frame_history> frame_ms{};
+  std::size_t frames = 0;
+
+  // Frames are only drawn when something on screen changed. While idle the
+  // loop blocks in waitEvent(); while autoplay runs it ticks at the frame
+  // limit.
+  bool redraw = true;
+  const sf::Time animation_tick = sf::milliseconds(16);
 
   sf::Clock deltaClock;
   while (window.isOpen()) {
+    const bool animating = autoplay && not generator.finished();
     sf::Event event{};
-    while (window.pollEvent(event)) {
+    bool have_event = animating || redraw ? window.pollEvent(event)
+                                          : window.waitEvent(event);
+    for (; have_event; have_event = window.pollEvent(event)) {
+      redraw |= show_overlay || event.type != sf::Event::MouseMoved;
       if (show_overlay) ImGui::SFML::ProcessEvent(event);
 
       if (event.type == sf::Event::Closed) {
@@ -304,6 +189,8 @@ outcome::result<void> Main(const std::vector<std::string>& args) {
 
       // catch the resize events
       if (event.type == sf::Event::Resized) {
+        view.setSize(static_cast<float>(event.size.width) * zoom,
+                     static_cast<float>(event.size.height) * zoom);
         // auto viewport =
         //     tictactoe::ComputeAspectPreservingViewport(window.getSize());
         // viewport_debug = viewport;
@@ -312,18 +199,76 @@ outcome::result<void> Main(const std::vector<std::string>& args) {
         // window.setView(view);
       }
 
+      if (event.type == sf::Event::KeyReleased &&
+          event.key.code == sf::Keyboard::Space) {
+        autoplay = not autoplay;
+      }
+
+      if (event.type == sf::Event::KeyReleased &&
+          event.key.code == sf::Keyboard::F1) {
+        show_overlay = not show_overlay;
+      }
+
+      if (event.type == sf::Event::KeyReleased &&
+          event.key.code == sf::Keyboard::S) {
+        show_solution = not show_solution;
+      }
+
+      if (event.type == sf::Event::MouseWheelScrolled &&
+          event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+        const float factor =
+            event.mouseWheelScroll.delta > 0 ? 1.0f / zoom_step : zoom_step;
+        view.zoom(factor);
+        zoom *= factor;
+      }
+
+      if (event.type == sf::Event::KeyPressed) {
+        const sf::Vector2f pan = view.getSize() * pan_step;
+        switch (event.key.code) {
+          case sf::Keyboard::Left: view.move(-pan.x, 0.0f); break;
+          case sf::Keyboard::Right: view.move(pan.x, 0.0f); break;
+          case sf::Keyboard::Up: view.move(0.0f, -pan.y); break;
+          case sf::Keyboard::Down: view.move(0.0f, pan.y); break;
+          default: break;
+        }
+      }
+
       if (event.type == sf::Event::MouseButtonReleased) {
         [[maybe_unused]] const sf::Vector2f mouse_pos_world =
             window.mapPixelToCoords(sf::Mouse::getPosition(window));
 
         // spdlog::info("click at ({}, {})", mouse_pos_world.x, mouse_pos_world.y);
-        if (std::next(display_iter) != data.end()) {
-          std::advance(display_iter, 1);
-          maze = OUTCOME_TRYX(SquareRectangularMaze::Make(*display_iter));
+        if (const auto carved = generator.Poll()) {
+          carve(*carved);
+          solution_stale = true;
         }
       }
     }
 
+    if (animating && generator.Drain(carves_per_frame, carve) > 0) {
+      redraw = true;
+      solution_stale = true;
+    }
+
+    if (not redraw) {
+      if (animating) sf::sleep(animation_tick);
+      continue;
+    }
+    redraw = false;
+    sf::Clock frame_clock;
+
+    if (show_solution && solution_stale) {
+      const MazeGraph graph = OUTCOME_TRYX(MazeGraph::Make(walls));
+      MazeSolver solver = OUTCOME_TRYX(MazeSolver::Make(graph));
+      const auto path = OUTCOME_TRYX(solver.Solve(
+          {0, 0}, {walls.num_rows() - 1, walls.num_cols() - 1},
+          SolverAlgorithm::AStar));
+      solution = MakePathOverlay(path, renderer.cell_size(),
+                                 tictactoe::Solarized::red);
+      solution_length = path.size();
+      solution_stale = false;
+    }
+
     if (show_overlay) {
       const auto window_size = window.getSize();
       const auto window_size_text =
@@ -332,24 +277,97 @@ outcome::result<void> Main(const std::vector<std::string>& args) {
           "viewport: {} {} {} {}", viewport_debug.left, viewport_debug.top,
           viewport_debug.height, viewport_debug.width);
 
+      // CPU time spent issuing the maze draw calls in the previous frame.
+      const auto& stats = renderer.last_draw();
+      const auto draw_text = fmt::format(
+          "maze draw: {:.2f} ms, {} draw calls", draw_time.asSeconds() * 1e3f,
+          draw_per_cell ? static_cast<std::size_t>(renderer.num_rows()) *
+                              static_cast<std::size_t>(renderer.num_cols())
+          : stats.lod ? std::size_t{1}
+                      : stats.chunks_drawn);
+      const auto chunks_text =
+          fmt::format("chunks cached: {}, zoom: {:.2f}{}", stats.chunks_cached,
+                      zoom, stats.lod ? ", bitmap" : "");
+
       ImGui::SFML::Update(window, deltaClock.restart());
       ImGui::Begin("Debug info");
       ImGui::TextUnformatted(window_size_text.c_str());
       ImGui::TextUnformatted(viewport_text.c_str());
+      ImGui::TextUnformatted(draw_text.c_str());
+      ImGui::TextUnformatted(chunks_text.c_str());
+      if (show_solution) {
+        const auto solution_text =
+            solution_length > 0
+                ? fmt::format("solution: {} cells", solution_length)
+                : std::string{"solution: not connected yet"};
+        ImGui::TextUnformatted(solution_text.c_str());
+      }
+      if (not maze_stats && generator.finished()) {
+        maze_stats = OUTCOME_TRYX(AnalyzeMaze(walls));
+      }
+      if (maze_stats) {
+        const auto shape_text = fmt::format(
+            "dead ends: {}, junctions: {}, corridors: {} (mean {:.2f})",
+            maze_stats->dead_ends(), maze_stats->junctions(),
+            maze_stats->num_corridors(), maze_stats->mean_corridor_length());
+        const auto factors_text = fmt::format(
+            "branching: {:.3f}, river: {:.2f}, diameter: {}",
+            maze_stats->branching_factor, maze_stats->river_factor,
+            maze_stats->diameter);
+        ImGui::TextUnformatted(shape_text.c_str());
+        ImGui::TextUnformatted(factors_text.c_str());
+      } else {
+        ImGui::TextUnformatted("maze stats: generating");
+      }
+      ImGui::Checkbox("draw per cell", &draw_per_cell);
+
+      const float last_frame_ms =
+          frame_ms[(frames + frame_history - 1) % frame_history];
+      const auto frame_text = fmt::format("frame: {:.2f} ms", last_frame_ms);
+      ImGui::PlotLines("##frame times", frame_ms.data(),
+                       static_cast<int>(frame_history),
+                       static_cast<int>(frames % frame_history),
+                       frame_text.c_str(), 0.0f, 1000.0f / 30.0f,
+                       ImVec2{0.0f, 120.0f});
+      if constexpr (util::kProfilingEnabled) {
+        if (ImGui::CollapsingHeader("phases")) {
+          for (const util::ProfileEntry& entry : util::ProfileSnapshot()) {
+            const auto entry_text = util::FormatProfileEntry(entry);
+            ImGui::TextUnformatted(entry_text.c_str());
+          }
+          if (ImGui::Button("reset")) util::ResetProfile();
+        }
+      } else {
+        ImGui::TextUnformatted("phases: build with ENABLE_PROFILING");
+      }
       ImGui::End();
     }
 
     window.clear(sf::Color::Black);
+    window.setView(view);
 
-    OUTCOME_TRYV(Draw(window, tiles_library, maze));
+    sf::Clock draw_clock;
+    if (draw_per_cell) {
+      DrawPerCell(window, tiles_library, renderer);
+    } else {
+      window.draw(renderer);
+    }
+    draw_time = draw_clock.getElapsedTime();
+    if (show_solution) window.draw(solution);
 
     if (show_overlay) ImGui::SFML::Render(window);
 
+    frame_ms[frames++ % frame_history] =
+        frame_clock.getElapsedTime().asSeconds() * 1e3f;
     window.display();
   }
 
   ImGui::SFML::Shutdown();
 
+  for (const util::ProfileEntry& entry : util::ProfileSnapshot()) {
+    spdlog::info("profile {}", util::FormatProfileEntry(entry));
+  }
+
   return outcome::success();
 }
 }  // namespace maze_walker
@@ -0,0 +1,172 @@
+#include "maze_flood.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <system_error>
+#include <utility>
+
+namespace maze_walker {
+namespace {
+
+using Word = FloodFill::Word;
+
+constexpr int kBitsPerWord = util::BitGrid::kBitsPerWord;
+
+}  // namespace
+
+FloodFill::FloodFill(WallPlanes walls)
+    : walls_{std::move(walls)},
+      words_per_row_{static_cast<std::size_t>(walls_.wall_down.words_per_row())},
+      visited_(walls_.wall_down.words().size()),
+      frontier_(visited_.size()),
+      next_(visited_.size()) {}
+
+outcome::result<FloodFill> FloodFill::Make(WallPlanes walls) {
+  if (walls.wall_down.words().size() >= kUnreachable) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+  return FloodFill{std::move(walls)};
+}
+
+outcome::result<FloodFill> FloodFill::Make(
+    const SquareRectangularMazeData& data) {
+  WallPlanes walls = OUTCOME_TRYX(FromMazeData(data));
+  return Make(std::move(walls));
+}
+
+outcome::result<FloodStats> FloodFill::Run(const Cell& source) {
+  return flood(source, nullptr, nullptr, nullptr);
+}
+
+outcome::result<FloodStats> FloodFill::Run(
+    const Cell& source, std::vector<std::uint32_t>& distances) {
+  distances.assign(static_cast<std::size_t>(num_rows()) *
+                       static_cast<std::size_t>(num_cols()),
+                   kUnreachable);
+  return flood(source, &distances, nullptr, nullptr);
+}
+
+outcome::result<FloodStats> FloodFill::Run(const Cell& source,
+                                           const Cell& target,
+                                           std::uint32_t& target_distance) {
+  if (not contains(target)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  target_distance = kUnreachable;
+  return flood(source, nullptr, &target, &target_distance);
+}
+
+bool FloodFill::contains(const Cell& cell) const {
+  return cell.row >= 0 && cell.row < num_rows() && cell.col >= 0 &&
+         cell.col < num_cols();
+}
+
+outcome::result<FloodStats> FloodFill::flood(
+    const Cell& source, std::vector<std::uint32_t>* distances,
+    const Cell* target, std::uint32_t* target_distance) {
+  if (not contains(source)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  // The word and bit of `target`, checked as each level lands.
+  const std::size_t target_word =
+      target ? static_cast<std::size_t>(target->row) * words_per_row_ +
+                   static_cast<std::size_t>(target->col / kBitsPerWord)
+             : visited_.size();
+  const Word target_bit =
+      target ? Word{1} << (target->col % kBitsPerWord) : Word{0};
+
+  std::fill(visited_.begin(), visited_.end(), Word{0});
+  const std::size_t start =
+      static_cast<std::size_t>(source.row) * words_per_row_ +
+      static_cast<std::size_t>(source.col / kBitsPerWord);
+  const Word start_bit = Word{1} << (source.col % kBitsPerWord);
+  visited_[start] = start_bit;
+  frontier_[start] = start_bit;
+  active_.assign(1, static_cast<std::uint32_t>(start));
+
+  FloodStats stats;
+  stats.reached = 1;
+  stats.farthest = source;
+  if (distances) {
+    (*distances)[static_cast<std::size_t>(source.row) *
+                     static_cast<std::size_t>(num_cols()) +
+                 static_cast<std::size_t>(source.col)] = 0;
+  }
+  if (start == target_word && (start_bit & target_bit) != 0) {
+    *target_distance = 0;
+  }
+
+  for (std::uint32_t level = 1; not active_.empty(); ++level) {
+    next_active_.clear();
+    for (const std::uint32_t word : active_) {
+      spread(word, frontier_[word]);
+      frontier_[word] = 0;
+    }
+    if (next_active_.empty()) break;
+
+    stats.eccentricity = level;
+    for (const std::uint32_t word : next_active_) {
+      const Word bits = next_[word];
+      visited_[word] |= bits;
+      stats.reached += static_cast<std::size_t>(std::popcount(bits));
+      if (word == target_word && (bits & target_bit) != 0) {
+        *target_distance = level;
+      }
+
+      const auto row = static_cast<int>(word / words_per_row_);
+      const auto col0 =
+          static_cast<int>(word % words_per_row_) * kBitsPerWord;
+      stats.farthest = Cell{row, col0 + std::countr_zero(bits)};
+      if (distances) {
+        std::uint32_t* out = distances->data() +
+                             static_cast<std::size_t>(row) *
+                                 static_cast<std::size_t>(num_cols()) +
+                             static_cast<std::size_t>(col0);
+        for (Word rest = bits; rest != 0; rest &= rest - 1) {
+          out[std::countr_zero(rest)] = level;
+        }
+      }
+    }
+    std::swap(frontier_, next_);
+    std::swap(active_, next_active_);
+  }
+  return stats;
+}
+
+// Moves the frontier bits of one word through every open wall into next_,
+// dropping cells already visited. A cell can go east when its own east wall
+// is open and west when the east wall of its west neighbour is, which is the
+// east plane shifted by one column; north and south work the same way with
+// the south plane one row apart. The boundary walls are always set in
+// WallPlanes, so nothing is shifted into padding bits or off the grid.
+void FloodFill::spread(std::uint32_t word, Word bits) {
+  const Word* down = walls_.wall_down.words().data();
+  const Word* right = walls_.wall_right.words().data();
+  const std::size_t col_word = word % words_per_row_;
+
+  const auto reach = [this](std::size_t target, Word moved) {
+    moved &= ~visited_[target];
+    if (moved == 0) return;
+    if (next_[target] == 0) {
+      next_active_.push_back(static_cast<std::uint32_t>(target));
+    }
+    next_[target] |= moved;
+  };
+
+  const Word east = bits & ~right[word];
+  reach(word, (east << 1) | ((bits >> 1) & ~right[word]));
+  if (col_word + 1 < words_per_row_ && (east >> (kBitsPerWord - 1)) != 0) {
+    reach(word + 1, Word{1});
+  }
+  if (col_word > 0 && (bits & 1u) != 0) {
+    reach(word - 1, (Word{1} << (kBitsPerWord - 1)) & ~right[word - 1]);
+  }
+  if (word + words_per_row_ < visited_.size()) {
+    reach(word + words_per_row_, bits & ~down[word]);
+  }
+  if (word >= words_per_row_) {
+    reach(word - words_per_row_, bits & ~down[word - words_per_row_]);
+  }
+}
+
+}  // namespace maze_walker
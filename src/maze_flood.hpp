@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <outcome.hpp>
+#include <vector>
+
+#include "maze_solver.hpp"
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+struct FloodStats {
+  // Distance to the farthest reachable cell.
+  std::uint32_t eccentricity = 0;
+  std::size_t reached = 0;
+  Cell farthest{0, 0};
+};
+
+// Breadth-first flood fill over the wall bit planes, 64 cells per operation.
+// The frontier and the visited set are bit planes laid out like WallPlanes;
+// one BFS level moves the whole frontier at once with word shifts masked by
+// the east and south walls (and the shifted walls for west and north).
+//
+// Mazes have long corridors, so the frontier is usually a thin band. Only the
+// words that hold frontier bits are visited on each level, which keeps a
+// level proportional to the frontier rather than to the grid.
+class FloodFill {
+ public:
+  using Word = util::BitGrid::Word;
+  static constexpr std::uint32_t kUnreachable =
+      std::numeric_limits<std::uint32_t>::max();
+
+ private:
+  WallPlanes walls_;
+  std::size_t words_per_row_;
+  std::vector<Word> visited_;
+  std::vector<Word> frontier_;
+  std::vector<Word> next_;
+  std::vector<std::uint32_t> active_;
+  std::vector<std::uint32_t> next_active_;
+
+  explicit FloodFill(WallPlanes walls);
+
+ public:
+  static outcome::result<FloodFill> Make(WallPlanes walls);
+  static outcome::result<FloodFill> Make(const SquareRectangularMazeData& data);
+
+  int num_rows() const { return walls_.num_rows(); }
+  int num_cols() const { return walls_.num_cols(); }
+
+  // Floods from `source`, keeping only the summary.
+  outcome::result<FloodStats> Run(const Cell& source);
+
+  // Also stores the distance of every cell from `source`, row-major, with
+  // kUnreachable for cells that cannot be reached.
+  outcome::result<FloodStats> Run(const Cell& source,
+                                  std::vector<std::uint32_t>& distances);
+
+  // Also sets `target_distance` to the distance of `target` from `source`,
+  // kUnreachable if it cannot be reached, without any per-cell output.
+  outcome::result<FloodStats> Run(const Cell& source, const Cell& target,
+                                  std::uint32_t& target_distance);
+
+ private:
+  bool contains(const Cell& cell) const;
+  outcome::result<FloodStats> flood(const Cell& source,
+                                    std::vector<std::uint32_t>* distances,
+                                    const Cell* target,
+                                    std::uint32_t* target_distance);
+  void spread(std::uint32_t word, Word bits);
+};
+
+}  // namespace maze_walker
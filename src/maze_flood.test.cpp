@@ -0,0 +1,147 @@
+#include "maze_flood.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <deque>
+
+#include "mazegen_growing_tree.hpp"
+
+namespace maze_walker {
+namespace {
+
+// Plain queue BFS over CellWalls, as the reference.
+std::vector<std::uint32_t> reference_distances(const WallPlanes& walls,
+                                               const Cell& source) {
+  const int cols = walls.num_cols();
+  std::vector<std::uint32_t> distances(
+      static_cast<std::size_t>(walls.num_rows() * cols),
+      FloodFill::kUnreachable);
+  const auto at = [&](const Cell& cell) -> std::uint32_t& {
+    return distances[static_cast<std::size_t>(cell.row * cols + cell.col)];
+  };
+  std::deque<Cell> queue{source};
+  at(source) = 0;
+  while (not queue.empty()) {
+    const Cell cell = queue.front();
+    queue.pop_front();
+    const WallMask mask = CellWalls(walls, cell.row, cell.col);
+    const Cell neighbours[] = {{cell.row - 1, cell.col},
+                               {cell.row, cell.col + 1},
+                               {cell.row + 1, cell.col},
+                               {cell.row, cell.col - 1}};
+    for (unsigned dir = 0; dir < 4; ++dir) {
+      if (mask & (1u << dir)) continue;
+      if (at(neighbours[dir]) != FloodFill::kUnreachable) continue;
+      at(neighbours[dir]) = at(cell) + 1;
+      queue.push_back(neighbours[dir]);
+    }
+  }
+  return distances;
+}
+
+}  // namespace
+
+TEST_CASE("Flood fill distances match a queue BFS", "[maze_flood]") {
+  const auto [cols, rows] = GENERATE(std::pair{1, 1}, std::pair{1, 40},
+                                     std::pair{63, 7}, std::pair{64, 9},
+                                     std::pair{65, 12}, std::pair{130, 21});
+  GrowingTreeOptions options;
+  options.seed = 5;
+  options.strategy =
+      GENERATE(SelectionStrategy::Newest, SelectionStrategy::Random);
+  const auto data = GenerateMaze(cols, rows, options).value();
+  const WallPlanes walls = FromMazeData(data).value();
+  FloodFill flood = FloodFill::Make(data).value();
+
+  const Cell source =
+      GENERATE_COPY(Cell{0, 0}, Cell{rows / 2, cols / 2},
+                    Cell{rows - 1, cols - 1});
+  std::vector<std::uint32_t> distances;
+  const FloodStats stats = flood.Run(source, distances).value();
+  const auto expected = reference_distances(walls, source);
+
+  REQUIRE(distances == expected);
+  REQUIRE(stats.reached == expected.size());
+  REQUIRE(stats.eccentricity ==
+          *std::max_element(expected.begin(), expected.end()));
+  REQUIRE(expected[static_cast<std::size_t>(stats.farthest.row * cols +
+                                            stats.farthest.col)] ==
+          stats.eccentricity);
+
+  const FloodStats summary = flood.Run(source).value();
+  REQUIRE(summary.eccentricity == stats.eccentricity);
+  REQUIRE(summary.reached == stats.reached);
+
+  for (const Cell& target : {source, Cell{0, 0}, Cell{rows - 1, cols - 1},
+                             stats.farthest}) {
+    std::uint32_t target_distance = 0;
+    const FloodStats to_target =
+        flood.Run(source, target, target_distance).value();
+    REQUIRE(target_distance ==
+            expected[static_cast<std::size_t>(target.row * cols +
+                                              target.col)]);
+    REQUIRE(to_target.reached == stats.reached);
+    REQUIRE(to_target.farthest == stats.farthest);
+  }
+}
+
+TEST_CASE("Flood fill stops at walls", "[maze_flood]") {
+  WallPlanes walls = WallPlanes::Make(3, 70).value();
+  // An open corridor along row 1, crossing the word boundary.
+  for (int col = 60; col < 69; ++col) {
+    walls.Carve(CarveEvent{1, col, Direction::East});
+  }
+  FloodFill flood = FloodFill::Make(std::move(walls)).value();
+
+  std::vector<std::uint32_t> distances;
+  const FloodStats stats = flood.Run(Cell{1, 64}, distances).value();
+  REQUIRE(stats.reached == 10);
+  REQUIRE(stats.eccentricity == 5);
+  REQUIRE(stats.farthest == Cell{1, 69});
+  REQUIRE(distances[70 + 60] == 4);
+  REQUIRE(distances[70 + 69] == 5);
+  REQUIRE(distances[70 + 59] == FloodFill::kUnreachable);
+  REQUIRE(distances[64] == FloodFill::kUnreachable);
+
+  std::uint32_t target_distance = 0;
+  REQUIRE(flood.Run(Cell{1, 64}, Cell{0, 64}, target_distance));
+  REQUIRE(target_distance == FloodFill::kUnreachable);
+}
+
+TEST_CASE("Flood fill on an open grid gives Manhattan distances",
+          "[maze_flood]") {
+  constexpr int kRows = 9;
+  constexpr int kCols = 100;
+  WallPlanes walls = WallPlanes::Make(kRows, kCols).value();
+  for (int row = 0; row < kRows; ++row) {
+    for (int col = 0; col < kCols; ++col) {
+      if (col + 1 < kCols) walls.Carve(CarveEvent{row, col, Direction::East});
+      if (row + 1 < kRows) walls.Carve(CarveEvent{row, col, Direction::South});
+    }
+  }
+  FloodFill flood = FloodFill::Make(std::move(walls)).value();
+
+  const Cell source{4, 63};
+  std::vector<std::uint32_t> distances;
+  const FloodStats stats = flood.Run(source, distances).value();
+  REQUIRE(stats.eccentricity == 4 + 63);
+  for (int row = 0; row < kRows; ++row) {
+    for (int col = 0; col < kCols; ++col) {
+      REQUIRE(distances[static_cast<std::size_t>(row * kCols + col)] ==
+              static_cast<std::uint32_t>(std::abs(row - source.row) +
+                                         std::abs(col - source.col)));
+    }
+  }
+}
+
+TEST_CASE("Flood fill rejects sources outside the maze", "[maze_flood]") {
+  FloodFill flood =
+      FloodFill::Make(WallPlanes::Make(4, 4).value()).value();
+  REQUIRE(flood.Run(Cell{4, 0}).has_error());
+  REQUIRE(flood.Run(Cell{0, -1}).has_error());
+  std::uint32_t target_distance = 0;
+  REQUIRE(flood.Run(Cell{0, 0}, Cell{0, 4}, target_distance).has_error());
+}
+
+}  // namespace maze_walker
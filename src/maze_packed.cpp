@@ -0,0 +1,139 @@
+#include "maze_packed.hpp"
+
+#include <bit>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#include "profile.hpp"
+
+namespace maze_walker {
+namespace {
+
+static_assert(std::endian::native == std::endian::little,
+              "the packed maze format is read in place as little-endian");
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t num_rows;
+  std::uint32_t num_cols;
+};
+static_assert(sizeof(Header) == 16);
+
+constexpr std::size_t kHeaderWords = sizeof(Header) / sizeof(PackedMaze::Word);
+
+std::size_t words_per_row(std::uint32_t num_cols) {
+  return (static_cast<std::size_t>(num_cols) + 63) / 64;
+}
+
+std::span<const std::byte> bytes_of(
+    const std::variant<std::vector<PackedMaze::Word>, util::MappedFile>&
+        storage) {
+  if (const auto* file = std::get_if<util::MappedFile>(&storage)) {
+    return file->bytes();
+  }
+  return std::as_bytes(
+      std::span{std::get<std::vector<PackedMaze::Word>>(storage)});
+}
+
+}  // namespace
+
+outcome::result<PackedMaze> PackedMaze::Parse(
+    std::variant<std::vector<Word>, util::MappedFile> storage) {
+  MAZE_PROFILE_SCOPE("packed.parse");
+  PackedMaze maze{std::move(storage)};
+  maze.bytes_ = bytes_of(maze.storage_);
+
+  Header header{};
+  if (maze.bytes_.size() < sizeof(header)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  std::memcpy(&header, maze.bytes_.data(), sizeof(header));
+  if (header.magic != kPackedMazeMagic ||
+      header.version != kPackedMazeVersion) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  if (header.num_rows == 0 || header.num_rows > INT_MAX ||
+      header.num_cols == 0 || header.num_cols > INT_MAX) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  const std::size_t plane_words = static_cast<std::size_t>(header.num_rows) *
+                                  words_per_row(header.num_cols);
+  if (maze.bytes_.size() != sizeof(header) + 2 * plane_words * sizeof(Word)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  const auto* words = reinterpret_cast<const Word*>(maze.bytes_.data());
+  maze.wall_down_ = words + kHeaderWords;
+  maze.wall_right_ = maze.wall_down_ + plane_words;
+  maze.num_rows_ = static_cast<int>(header.num_rows);
+  maze.num_cols_ = static_cast<int>(header.num_cols);
+  maze.words_per_row_ = words_per_row(header.num_cols);
+  return maze;
+}
+
+outcome::result<PackedMaze> PackedMaze::Open(
+    const std::filesystem::path& path) {
+  return Parse(OUTCOME_TRYX(util::MappedFile::Open(path)));
+}
+
+outcome::result<PackedMaze> PackedMaze::Make(const WallPlanes& walls) {
+  const auto& down = walls.wall_down.words();
+  const auto& right = walls.wall_right.words();
+
+  // The Header fields, two to a little-endian word.
+  std::vector<Word> image;
+  image.reserve(kHeaderWords + down.size() + right.size());
+  image.push_back(Word{kPackedMazeVersion} << 32 | kPackedMazeMagic);
+  image.push_back(static_cast<Word>(walls.num_cols()) << 32 |
+                  static_cast<Word>(walls.num_rows()));
+  image.insert(image.end(), down.begin(), down.end());
+  image.insert(image.end(), right.begin(), right.end());
+  return Parse(std::move(image));
+}
+
+outcome::result<PackedMaze> PackedMaze::Make(
+    const SquareRectangularMazeData& data) {
+  return Make(OUTCOME_TRYX(FromMazeData(data)));
+}
+
+outcome::result<void> PackedMaze::Save(
+    const std::filesystem::path& path) const {
+  std::ofstream out{path, std::ios::binary | std::ios::trunc};
+  out.write(reinterpret_cast<const char*>(bytes_.data()),
+            static_cast<std::streamsize>(bytes_.size()));
+  out.close();
+  if (not out) {
+    return outcome::failure(std::errc::io_error);
+  }
+  return outcome::success();
+}
+
+outcome::result<SquareRectangularMazeData> ToMazeData(const PackedMaze& maze) {
+  // A repeated field holds at most INT_MAX entries.
+  if (static_cast<std::int64_t>(maze.num_rows()) * maze.num_cols() > INT_MAX) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+  SquareRectangularMazeData data;
+  data.set_num_cols(maze.num_cols());
+  data.set_num_rows(maze.num_rows());
+  data.mutable_walls()->Reserve(maze.num_rows() * maze.num_cols());
+
+  for (int row = 0; row < maze.num_rows(); ++row) {
+    for (int col = 0; col < maze.num_cols(); ++col) {
+      const auto pos = OUTCOME_TRYX(maze.make_position(row, col));
+      auto* cell = data.add_walls();
+      cell->set_n(maze.has_wall_north(pos));
+      cell->set_e(maze.has_wall_east(pos));
+      cell->set_s(maze.has_wall_south(pos));
+      cell->set_w(maze.has_wall_west(pos));
+    }
+  }
+
+  return data;
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <outcome.hpp>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// On-disk layout, little-endian throughout:
+//
+//   u32 magic ("MZPK"), u32 version, u32 num_rows, u32 num_cols
+//   u64 wall_down[num_rows][words_per_row]
+//   u64 wall_right[num_rows][words_per_row]
+//
+// i.e. the two WallPlanes bit planes verbatim, with words_per_row =
+// ceil(num_cols / 64) and zero padding bits. The header keeps the planes
+// 8-byte aligned, so a mapped file is queried in place.
+inline constexpr std::uint32_t kPackedMazeMagic = 0x4b505a4d;
+inline constexpr std::uint32_t kPackedMazeVersion = 1;
+
+// A maze in the packed format, either mapped from disk or encoded in memory.
+// Answers the same wall queries as SquareRectangularMaze at 2 bits per cell,
+// with rows padded to 64-bit words (16 bytes per row at least), and without
+// parsing: opening a file only validates its header and size.
+class PackedMaze {
+ public:
+  using Word = util::BitGrid::Word;
+
+ private:
+  std::variant<std::vector<Word>, util::MappedFile> storage_;
+  std::span<const std::byte> bytes_;
+  const Word* wall_down_ = nullptr;
+  const Word* wall_right_ = nullptr;
+  int num_rows_ = 0;
+  int num_cols_ = 0;
+  std::size_t words_per_row_ = 0;
+
+  explicit PackedMaze(std::variant<std::vector<Word>, util::MappedFile> storage)
+      : storage_{std::move(storage)} {}
+
+  static outcome::result<PackedMaze> Parse(
+      std::variant<std::vector<Word>, util::MappedFile> storage);
+
+ public:
+  static outcome::result<PackedMaze> Open(const std::filesystem::path& path);
+  static outcome::result<PackedMaze> Make(const WallPlanes& walls);
+  static outcome::result<PackedMaze> Make(
+      const SquareRectangularMazeData& data);
+
+  // The encoded file, header included.
+  std::span<const std::byte> bytes() const { return bytes_; }
+  outcome::result<void> Save(const std::filesystem::path& path) const;
+
+  int num_rows() const { return num_rows_; }
+  int num_cols() const { return num_cols_; }
+
+  class ValidPosition {
+    int row_;
+    int col_;
+
+    ValidPosition(int row, int col) : row_{row}, col_{col} {}
+    friend class PackedMaze;
+
+   public:
+    int row() const { return row_; }
+    int col() const { return col_; }
+  };
+
+  outcome::result<ValidPosition> make_position(int row, int col) const {
+    if (row < 0 || row >= num_rows() || col < 0 || col >= num_cols()) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+    return outcome::success(ValidPosition{row, col});
+  }
+
+  bool has_wall_north(const ValidPosition& pos) const {
+    return pos.row() == 0 || test(wall_down_, pos.row() - 1, pos.col());
+  }
+
+  bool has_wall_east(const ValidPosition& pos) const {
+    return pos.col() == num_cols() - 1 ||
+           test(wall_right_, pos.row(), pos.col());
+  }
+
+  bool has_wall_south(const ValidPosition& pos) const {
+    return pos.row() == num_rows() - 1 ||
+           test(wall_down_, pos.row(), pos.col());
+  }
+
+  bool has_wall_west(const ValidPosition& pos) const {
+    return pos.col() == 0 || test(wall_right_, pos.row(), pos.col() - 1);
+  }
+
+  std::bitset<4> walls(const ValidPosition& pos) const {
+    std::bitset<4> walls;
+    walls[0] = has_wall_north(pos);
+    walls[1] = has_wall_east(pos);
+    walls[2] = has_wall_south(pos);
+    walls[3] = has_wall_west(pos);
+    return walls;
+  }
+
+ private:
+  bool test(const Word* plane, int row, int col) const {
+    const auto word = static_cast<std::size_t>(row) * words_per_row_ +
+                      static_cast<std::size_t>(col) / 64;
+    return (plane[word] >> (static_cast<unsigned>(col) % 64)) & 1u;
+  }
+};
+
+outcome::result<SquareRectangularMazeData> ToMazeData(const PackedMaze& maze);
+
+}  // namespace maze_walker
@@ -0,0 +1,102 @@
+#include "maze_packed.hpp"
+
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "mazegen_growing_tree.hpp"
+
+namespace maze_walker {
+namespace {
+
+std::filesystem::path temp_path(const char* name) {
+  return std::filesystem::temp_directory_path() / name;
+}
+
+}  // namespace
+
+TEST_CASE("Packed maze round trips through the proto", "[maze_packed]") {
+  const int cols = GENERATE(1, 63, 64, 65, 130);
+  const int rows = GENERATE(1, 7);
+  GrowingTreeOptions options;
+  options.seed = 17;
+  const SquareRectangularMazeData data =
+      GenerateMaze(cols, rows, options).value();
+
+  const PackedMaze packed = PackedMaze::Make(data).value();
+  REQUIRE(packed.num_rows() == rows);
+  REQUIRE(packed.num_cols() == cols);
+  const auto words_per_row = static_cast<std::size_t>((cols + 63) / 64);
+  REQUIRE(packed.bytes().size() ==
+          16 + 2 * static_cast<std::size_t>(rows) * words_per_row * 8);
+  REQUIRE(ToMazeData(packed).value().SerializeAsString() ==
+          data.SerializeAsString());
+
+  const WallPlanes walls = FromMazeData(data).value();
+  for (int idx = 0; idx < rows * cols; ++idx) {
+    const auto pos = packed.make_position(idx / cols, idx % cols).value();
+    const auto& cell = data.walls(idx);
+    const std::bitset<4> expected{(cell.n() ? 1u : 0u) | (cell.e() ? 2u : 0u) |
+                                  (cell.s() ? 4u : 0u) | (cell.w() ? 8u : 0u)};
+    REQUIRE(packed.walls(pos) == expected);
+    REQUIRE(CellWalls(walls, idx / cols, idx % cols) == expected.to_ulong());
+  }
+}
+
+TEST_CASE("Packed maze saves and maps back", "[maze_packed]") {
+  GrowingTreeOptions options;
+  options.seed = 3;
+  const auto data = GenerateMaze(100, 50, options).value();
+  const auto path = temp_path("maze_packed_test.mzpk");
+
+  REQUIRE(PackedMaze::Make(data).value().Save(path));
+  const PackedMaze opened = PackedMaze::Open(path).value();
+  REQUIRE(ToMazeData(opened).value().SerializeAsString() ==
+          data.SerializeAsString());
+  std::filesystem::remove(path);
+
+  REQUIRE_FALSE(PackedMaze::Open(temp_path("maze_packed_missing.mzpk")));
+}
+
+TEST_CASE("Packed maze rejects malformed input", "[maze_packed]") {
+  const auto path = temp_path("maze_packed_bad.mzpk");
+  const PackedMaze packed =
+      PackedMaze::Make(WallPlanes::Make(4, 70).value()).value();
+  const auto bytes = packed.bytes();
+  const auto save_bytes = [&path](std::span<const std::byte> content) {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char*>(content.data()),
+              static_cast<std::streamsize>(content.size()));
+  };
+
+  SECTION("Truncated") {
+    save_bytes(bytes.first(bytes.size() - 8));
+    REQUIRE_FALSE(PackedMaze::Open(path));
+    save_bytes(bytes.first(10));
+    REQUIRE_FALSE(PackedMaze::Open(path));
+    save_bytes({});
+    REQUIRE_FALSE(PackedMaze::Open(path));
+  }
+
+  SECTION("Wrong magic or version") {
+    std::vector<std::byte> copy{bytes.begin(), bytes.end()};
+    copy[0] = std::byte{'X'};
+    save_bytes(copy);
+    REQUIRE_FALSE(PackedMaze::Open(path));
+
+    copy = {bytes.begin(), bytes.end()};
+    copy[4] = std::byte{2};
+    save_bytes(copy);
+    REQUIRE_FALSE(PackedMaze::Open(path));
+  }
+
+  std::filesystem::remove(path);
+
+  SquareRectangularMazeData data;
+  data.set_num_rows(2);
+  data.set_num_cols(2);
+  data.add_walls();
+  REQUIRE_FALSE(PackedMaze::Make(data));
+}
+}  // namespace maze_walker
@@ -0,0 +1,374 @@
+#include "maze_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "profile.hpp"
+#include "solarized.hpp"
+
+namespace maze_walker {
+namespace {
+
+constexpr std::size_t kVerticesPerCell = 4;
+
+Direction opposite(Direction dir) {
+  return static_cast<Direction>((static_cast<unsigned>(dir) + 2) % 4);
+}
+
+void set_texture_coords(sf::Vertex* quad, const sf::IntRect& rect) {
+  const auto left = static_cast<float>(rect.left);
+  const auto top = static_cast<float>(rect.top);
+  const auto right = static_cast<float>(rect.left + rect.width);
+  const auto bottom = static_cast<float>(rect.top + rect.height);
+  quad[0].texCoords = {left, top};
+  quad[1].texCoords = {right, top};
+  quad[2].texCoords = {right, bottom};
+  quad[3].texCoords = {left, bottom};
+}
+
+// Index of the chunk containing world coordinate `world`, clamped to
+// [0, count].
+int chunk_at(float world, float chunk_size, int count) {
+  const float chunk = std::floor(world / chunk_size);
+  return static_cast<int>(std::clamp(chunk, 0.0f, static_cast<float>(count)));
+}
+
+sf::Uint8 mix(sf::Uint8 from, sf::Uint8 to, float ratio) {
+  return static_cast<sf::Uint8>(static_cast<float>(from) +
+                                (static_cast<float>(to) -
+                                 static_cast<float>(from)) *
+                                    ratio);
+}
+
+}  // namespace
+
+outcome::result<TilesLibrary> TilesLibrary::Make(
+    const std::filesystem::path& path_to_texture) {
+  TilesLibrary tl;
+  const int pixel_width = 128;
+  const int pixel_height = 128;
+  tl.texture_.loadFromFile(path_to_texture.string());
+
+  std::vector<std::pair<int, int>> offsets = {
+      {9, 0},  // 0 - all open
+      {5, 3},  // 1 - N
+      {5, 2},  // 2 - E
+      {6, 0},  // 3 - NE
+      {4, 3},  // 4 - S
+      {0, 1},  // 5 - NS
+      {6, 1},  // 6 - SE
+      {9, 3},  // 7 - NES
+      {4, 2},  // 8 - W
+      {5, 0},  // 9 - NW
+      {0, 0},  // 10 - EW
+      {8, 2},  // 11 - NEW
+      {5, 1},  // 12 - SW
+      {8, 3},  // 13 - NSW
+      {9, 2},  // 14 - ESW
+      {0, 2},  // 15 - NESW
+  };
+
+  using VI = sf::Vector2i;
+
+  const auto size = VI{pixel_width, pixel_height};
+
+  tl.base_tiles_.reserve(offsets.size());
+  std::transform(
+      offsets.begin(), offsets.end(), std::back_inserter(tl.base_tiles_),
+      [&](const std::pair<int, int>& offset) {
+        return sf::IntRect{
+            VI{offset.first * pixel_width, offset.second * pixel_height},
+            size};
+      });
+
+  return tl;
+}
+
+MazeRenderer::MazeRenderer(const TilesLibrary& tiles, int num_rows,
+                           int num_cols, float cell_size)
+    : tiles_{&tiles},
+      num_rows_{num_rows},
+      num_cols_{num_cols},
+      cell_size_{cell_size},
+      walls_(static_cast<std::size_t>(num_rows) *
+             static_cast<std::size_t>(num_cols)),
+      lod_block_{(std::max(num_rows, num_cols) + kMaxLodSide - 1) /
+                 kMaxLodSide} {}
+
+outcome::result<MazeRenderer> MazeRenderer::Make(
+    const TilesLibrary& tiles, const SquareRectangularMaze& maze,
+    float cell_size) {
+  if (not(cell_size > 0.0f)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  MazeRenderer renderer{tiles, maze.num_rows(), maze.num_cols(), cell_size};
+  for (int row = 0; row < maze.num_rows(); ++row) {
+    for (int col = 0; col < maze.num_cols(); ++col) {
+      const auto pos = OUTCOME_TRYX(maze.make_position(row, col));
+      renderer.walls_[renderer.cell_index(row, col)] =
+          static_cast<WallMask>(maze.walls(pos).to_ulong());
+    }
+  }
+  renderer.build_lod();
+  return renderer;
+}
+
+outcome::result<MazeRenderer> MazeRenderer::Make(const TilesLibrary& tiles,
+                                                 const WallPlanes& walls,
+                                                 float cell_size) {
+  if (not(cell_size > 0.0f)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  MazeRenderer renderer{tiles, walls.num_rows(), walls.num_cols(), cell_size};
+  for (int row = 0; row < walls.num_rows(); ++row) {
+    RowWalls(walls, row,
+             std::span{renderer.walls_}.subspan(
+                 renderer.cell_index(row, 0),
+                 static_cast<std::size_t>(walls.num_cols())));
+  }
+  renderer.build_lod();
+  return renderer;
+}
+
+void MazeRenderer::SetWalls(int row, int col, WallMask walls) {
+  walls_[cell_index(row, col)] = walls;
+  update_quad(row, col);
+  update_lod_pixel(row, col);
+}
+
+void MazeRenderer::Carve(const CarveEvent& event) {
+  int row = event.row;
+  int col = event.col;
+  const WallMask front = WallBit(event.direction);
+  SetWalls(row, col, walls(row, col) & static_cast<WallMask>(~front));
+
+  switch (event.direction) {
+    case Direction::North: --row; break;
+    case Direction::East: ++col; break;
+    case Direction::South: ++row; break;
+    case Direction::West: --col; break;
+  }
+  const WallMask back = WallBit(opposite(event.direction));
+  SetWalls(row, col, walls(row, col) & static_cast<WallMask>(~back));
+}
+
+void MazeRenderer::draw(sf::RenderTarget& target,
+                        sf::RenderStates states) const {
+  MAZE_PROFILE_SCOPE("render.draw");
+  ++frame_;
+  stats_ = DrawStats{};
+
+  const sf::View& view = target.getView();
+  const sf::Vector2f view_size = view.getSize();
+  const float screen_width =
+      static_cast<float>(target.getSize().x) * view.getViewport().width;
+  if (cell_size_ * screen_width / view_size.x < kMinCellPixels) {
+    draw_lod(target, states);
+    stats_.chunks_cached = chunks_.size();
+    return;
+  }
+
+  const sf::Vector2f top_left = view.getCenter() - view_size / 2.0f;
+  const float chunk_size = cell_size_ * static_cast<float>(kChunkSide);
+  const int row_begin = chunk_at(top_left.y, chunk_size, chunk_rows());
+  const int row_end =
+      chunk_at(top_left.y + view_size.y + chunk_size, chunk_size, chunk_rows());
+  const int col_begin = chunk_at(top_left.x, chunk_size, chunk_cols());
+  const int col_end =
+      chunk_at(top_left.x + view_size.x + chunk_size, chunk_size, chunk_cols());
+
+  states.texture = tiles_->texture();
+  for (int chunk_row = row_begin; chunk_row < row_end; ++chunk_row) {
+    for (int chunk_col = col_begin; chunk_col < col_end; ++chunk_col) {
+      Chunk& chunk = cached_chunk(chunk_row, chunk_col);
+      chunk.last_drawn = frame_;
+      target.draw(chunk.vertices, states);
+      ++stats_.chunks_drawn;
+    }
+  }
+
+  evict_chunks();
+  stats_.chunks_cached = chunks_.size();
+}
+
+void MazeRenderer::draw_lod(sf::RenderTarget& target,
+                            sf::RenderStates states) const {
+  stats_.lod = true;
+  if (lod_texture_.getSize() != lod_image_.getSize()) {
+    const auto size = lod_image_.getSize();
+    if (not lod_texture_.create(size.x, size.y)) return;
+    lod_texture_.setSmooth(true);
+    lod_uploaded_ = false;
+  }
+  if (not lod_uploaded_) {
+    MAZE_PROFILE_SCOPE("render.lod_upload");
+    lod_texture_.update(lod_image_);
+    lod_uploaded_ = true;
+  }
+
+  sf::Sprite sprite{lod_texture_};
+  const float pixel_size = cell_size_ * static_cast<float>(lod_block_);
+  sprite.setScale(pixel_size, pixel_size);
+  target.draw(sprite, states);
+}
+
+MazeRenderer::Chunk& MazeRenderer::cached_chunk(int chunk_row,
+                                                int chunk_col) const {
+  const auto [it, inserted] =
+      chunks_.try_emplace(chunk_key(chunk_row, chunk_col));
+  if (not inserted) return it->second;
+  MAZE_PROFILE_SCOPE("render.build_chunk");
+
+  const int row_begin = chunk_row * kChunkSide;
+  const int row_end = std::min(num_rows_, row_begin + kChunkSide);
+  const int col_begin = chunk_col * kChunkSide;
+  const int col_end = std::min(num_cols_, col_begin + kChunkSide);
+
+  sf::VertexArray& vertices = it->second.vertices;
+  vertices.setPrimitiveType(sf::Quads);
+  vertices.resize(static_cast<std::size_t>(row_end - row_begin) *
+                  static_cast<std::size_t>(col_end - col_begin) *
+                  kVerticesPerCell);
+  MAZE_PROFILE_COUNT("render.alloc_bytes",
+                     vertices.getVertexCount() * sizeof(sf::Vertex));
+  std::size_t vertex = 0;
+  for (int row = row_begin; row < row_end; ++row) {
+    for (int col = col_begin; col < col_end; ++col, vertex += 4) {
+      const float left = cell_size_ * static_cast<float>(col);
+      const float top = cell_size_ * static_cast<float>(row);
+      sf::Vertex* quad = &vertices[vertex];
+      quad[0].position = {left, top};
+      quad[1].position = {left + cell_size_, top};
+      quad[2].position = {left + cell_size_, top + cell_size_};
+      quad[3].position = {left, top + cell_size_};
+      set_texture_coords(quad, tiles_->texture_rect_for(walls(row, col)));
+    }
+  }
+  return it->second;
+}
+
+// Drops the least recently drawn chunks beyond kMaxCachedChunks, but never
+// one drawn this frame.
+void MazeRenderer::evict_chunks() const {
+  if (chunks_.size() <= kMaxCachedChunks) return;
+
+  std::vector<std::pair<std::uint64_t, std::size_t>> stale;
+  for (const auto& [key, chunk] : chunks_) {
+    if (chunk.last_drawn < frame_) stale.emplace_back(chunk.last_drawn, key);
+  }
+  const std::size_t excess =
+      std::min(stale.size(), chunks_.size() - kMaxCachedChunks);
+  std::partial_sort(stale.begin(),
+                    stale.begin() + static_cast<std::ptrdiff_t>(excess),
+                    stale.end());
+  MAZE_PROFILE_COUNT("render.chunks_evicted", excess);
+  for (std::size_t i = 0; i < excess; ++i) {
+    chunks_.erase(stale[i].second);
+  }
+}
+
+void MazeRenderer::update_quad(int row, int col) {
+  const int chunk_row = row / kChunkSide;
+  const int chunk_col = col / kChunkSide;
+  const auto it = chunks_.find(chunk_key(chunk_row, chunk_col));
+  if (it == chunks_.end()) return;
+
+  const int chunk_width =
+      std::min(num_cols_ - chunk_col * kChunkSide, kChunkSide);
+  const auto cell = static_cast<std::size_t>(row % kChunkSide) *
+                        static_cast<std::size_t>(chunk_width) +
+                    static_cast<std::size_t>(col % kChunkSide);
+  set_texture_coords(&it->second.vertices[cell * kVerticesPerCell],
+                     tiles_->texture_rect_for(walls(row, col)));
+}
+
+// Shades the bitmap pixel of the block holding (row, col) between the wall
+// and the passage colour by the share of inner walls of the block that are
+// open.
+void MazeRenderer::update_lod_pixel(int row, int col) {
+  const int block_row = row / lod_block_;
+  const int block_col = col / lod_block_;
+  const int row_begin = block_row * lod_block_;
+  const int row_end = std::min(num_rows_, row_begin + lod_block_);
+  const int col_begin = block_col * lod_block_;
+  const int col_end = std::min(num_cols_, col_begin + lod_block_);
+
+  int walls_seen = 0;
+  int open = 0;
+  for (int r = row_begin; r < row_end; ++r) {
+    for (int c = col_begin; c < col_end; ++c) {
+      const WallMask mask = walls(r, c);
+      if (c + 1 < num_cols_) {
+        ++walls_seen;
+        open += (mask & WallBit(Direction::East)) ? 0 : 1;
+      }
+      if (r + 1 < num_rows_) {
+        ++walls_seen;
+        open += (mask & WallBit(Direction::South)) ? 0 : 1;
+      }
+    }
+  }
+
+  // A perfect maze has about one open wall per cell, i.e. half of them.
+  const float ratio =
+      walls_seen == 0
+          ? 1.0f
+          : std::min(1.0f, 2.0f * static_cast<float>(open) /
+                               static_cast<float>(walls_seen));
+  const sf::Color& wall = tictactoe::Solarized::base03;
+  const sf::Color& passage = tictactoe::Solarized::base1;
+  lod_image_.setPixel(static_cast<unsigned>(block_col),
+                      static_cast<unsigned>(block_row),
+                      sf::Color{mix(wall.r, passage.r, ratio),
+                                mix(wall.g, passage.g, ratio),
+                                mix(wall.b, passage.b, ratio)});
+  lod_uploaded_ = false;
+}
+
+void MazeRenderer::build_lod() {
+  MAZE_PROFILE_SCOPE("render.build_lod");
+  const int width = (num_cols_ + lod_block_ - 1) / lod_block_;
+  const int height = (num_rows_ + lod_block_ - 1) / lod_block_;
+  lod_image_.create(static_cast<unsigned>(width),
+                    static_cast<unsigned>(height));
+  MAZE_PROFILE_COUNT("render.alloc_bytes", width * height * 4);
+  for (int row = 0; row < num_rows_; row += lod_block_) {
+    for (int col = 0; col < num_cols_; col += lod_block_) {
+      update_lod_pixel(row, col);
+    }
+  }
+}
+
+sf::VertexArray MakePathOverlay(const std::vector<Cell>& path, float cell_size,
+                                const sf::Color& color) {
+  sf::VertexArray quads{sf::Quads};
+  const float half_width = cell_size / 8.0f;
+  const auto centre = [cell_size](const Cell& cell) {
+    return sf::Vector2f{(static_cast<float>(cell.col) + 0.5f) * cell_size,
+                        (static_cast<float>(cell.row) + 0.5f) * cell_size};
+  };
+
+  // One axis-aligned quad per step; a single cell gets a square.
+  const std::size_t steps = path.size() > 1 ? path.size() - 1 : path.size();
+  for (std::size_t i = 0; i < steps; ++i) {
+    const sf::Vector2f a = centre(path[i]);
+    const sf::Vector2f b = centre(path[std::min(i + 1, path.size() - 1)]);
+    const float left = std::min(a.x, b.x) - half_width;
+    const float right = std::max(a.x, b.x) + half_width;
+    const float top = std::min(a.y, b.y) - half_width;
+    const float bottom = std::max(a.y, b.y) + half_width;
+    quads.append(sf::Vertex{{left, top}, color});
+    quads.append(sf::Vertex{{right, top}, color});
+    quads.append(sf::Vertex{{right, bottom}, color});
+    quads.append(sf::Vertex{{left, bottom}, color});
+  }
+  return quads;
+}
+
+}  // namespace maze_walker
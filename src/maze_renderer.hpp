@@ -0,0 +1,138 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <outcome.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "maze_solver.hpp"
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+class TilesLibrary {
+  sf::Texture texture_;
+  std::vector<sf::IntRect> base_tiles_;
+
+ public:
+  static outcome::result<TilesLibrary> Make(
+      const std::filesystem::path& path_to_texture);
+
+  sf::Texture const* texture() const { return &texture_; }
+  const sf::IntRect& texture_rect_for(std::bitset<4> tile_type) const {
+    return base_tiles_[tile_type.to_ulong()];
+  }
+};
+
+// Draws a maze of any size at a cost bounded by what is on screen. The maze
+// is split into square chunks of cells; only the chunks intersecting the
+// target's view are drawn, each as one vertex array of textured quads whose
+// geometry is built the first time the chunk is seen and cached after that.
+// When cells get smaller than a few pixels, the maze is drawn instead from a
+// downsampled bitmap, one pixel per block of cells shaded by how open the
+// block is.
+//
+// Carving a passage rewrites only the quads of the two cells it joins (if
+// their chunk is cached) and one pixel of the bitmap. Culling assumes the
+// maze is drawn without an extra transform.
+class MazeRenderer : public sf::Drawable {
+ public:
+  static constexpr int kChunkSide = 64;
+  static constexpr std::size_t kMaxCachedChunks = 128;
+  static constexpr float kMinCellPixels = 4.0f;
+  static constexpr int kMaxLodSide = 2048;
+
+  struct DrawStats {
+    std::size_t chunks_drawn = 0;
+    std::size_t chunks_cached = 0;
+    bool lod = false;
+  };
+
+ private:
+  struct Chunk {
+    sf::VertexArray vertices;
+    std::uint64_t last_drawn = 0;
+  };
+
+  const TilesLibrary* tiles_;
+  int num_rows_;
+  int num_cols_;
+  float cell_size_;
+  std::vector<WallMask> walls_;
+
+  // Cells per bitmap pixel along each axis.
+  int lod_block_;
+
+  // draw() is const for sf::Drawable, so the caches it fills are mutable.
+  mutable std::unordered_map<std::size_t, Chunk> chunks_;
+  mutable std::uint64_t frame_ = 0;
+  mutable DrawStats stats_;
+  mutable sf::Image lod_image_;
+  mutable sf::Texture lod_texture_;
+  mutable bool lod_uploaded_ = false;
+
+  MazeRenderer(const TilesLibrary& tiles, int num_rows, int num_cols,
+               float cell_size);
+
+ public:
+  static outcome::result<MazeRenderer> Make(const TilesLibrary& tiles,
+                                            const SquareRectangularMaze& maze,
+                                            float cell_size = 50.0f);
+  static outcome::result<MazeRenderer> Make(const TilesLibrary& tiles,
+                                            const WallPlanes& walls,
+                                            float cell_size = 50.0f);
+
+  int num_rows() const { return num_rows_; }
+  int num_cols() const { return num_cols_; }
+  float cell_size() const { return cell_size_; }
+
+  // Walls currently drawn for the cell; no bounds checking.
+  WallMask walls(int row, int col) const {
+    return walls_[cell_index(row, col)];
+  }
+
+  void SetWalls(int row, int col, WallMask walls);
+
+  // Opens the wall described by `event` on both of its sides.
+  void Carve(const CarveEvent& event);
+
+  // What the last draw() did.
+  const DrawStats& last_draw() const { return stats_; }
+
+ private:
+  void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+  void draw_lod(sf::RenderTarget& target, sf::RenderStates states) const;
+
+  std::size_t cell_index(int row, int col) const {
+    return static_cast<std::size_t>(row) * static_cast<std::size_t>(num_cols_) +
+           static_cast<std::size_t>(col);
+  }
+
+  int chunk_rows() const { return (num_rows_ + kChunkSide - 1) / kChunkSide; }
+  int chunk_cols() const { return (num_cols_ + kChunkSide - 1) / kChunkSide; }
+  std::size_t chunk_key(int chunk_row, int chunk_col) const {
+    return static_cast<std::size_t>(chunk_row) *
+               static_cast<std::size_t>(chunk_cols()) +
+           static_cast<std::size_t>(chunk_col);
+  }
+
+  Chunk& cached_chunk(int chunk_row, int chunk_col) const;
+  void evict_chunks() const;
+  void update_quad(int row, int col);
+  void update_lod_pixel(int row, int col);
+  void build_lod();
+};
+
+// A thick line through the centres of the cells of `path`, as quads, to be
+// drawn over a MazeRenderer with the same cell size.
+sf::VertexArray MakePathOverlay(const std::vector<Cell>& path, float cell_size,
+                                const sf::Color& color);
+
+}  // namespace maze_walker
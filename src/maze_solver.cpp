@@ -0,0 +1,175 @@
+#include "maze_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <system_error>
+
+namespace maze_walker {
+namespace {
+
+constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+
+// Index offsets of the neighbours in NESW order; the negative ones rely on
+// unsigned wrap-around.
+std::array<std::uint32_t, 4> neighbour_steps(int num_cols) {
+  const auto cols = static_cast<std::uint32_t>(num_cols);
+  return {0u - cols, 1u, cols, 0u - 1u};
+}
+
+outcome::result<void> check_size(int num_rows, int num_cols) {
+  const auto cells = static_cast<std::uint64_t>(num_rows) *
+                     static_cast<std::uint64_t>(num_cols);
+  if (cells >= kNone) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+  return outcome::success();
+}
+
+}  // namespace
+
+outcome::result<MazeGraph> MazeGraph::Make(
+    const SquareRectangularMaze& maze) {
+  OUTCOME_TRYV(check_size(maze.num_rows(), maze.num_cols()));
+  MazeGraph graph{maze.num_rows(), maze.num_cols()};
+  std::size_t idx = 0;
+  for (int row = 0; row < maze.num_rows(); ++row) {
+    for (int col = 0; col < maze.num_cols(); ++col, ++idx) {
+      const auto pos = OUTCOME_TRYX(maze.make_position(row, col));
+      graph.open_[idx] =
+          static_cast<WallMask>(~maze.walls(pos).to_ulong() & 0xfu);
+    }
+  }
+  return graph;
+}
+
+outcome::result<MazeGraph> MazeGraph::Make(const WallPlanes& walls) {
+  OUTCOME_TRYV(check_size(walls.num_rows(), walls.num_cols()));
+  MazeGraph graph{walls.num_rows(), walls.num_cols()};
+  std::size_t idx = 0;
+  for (int row = 0; row < walls.num_rows(); ++row) {
+    for (int col = 0; col < walls.num_cols(); ++col, ++idx) {
+      graph.open_[idx] =
+          static_cast<WallMask>(~CellWalls(walls, row, col) & 0xfu);
+    }
+  }
+  return graph;
+}
+
+MazeSolver::MazeSolver(const MazeGraph& graph)
+    : graph_{&graph},
+      parent_(graph.num_cells()),
+      distance_(graph.num_cells()),
+      queue_(graph.num_cells()) {}
+
+outcome::result<MazeSolver> MazeSolver::Make(const MazeGraph& graph) {
+  return MazeSolver{graph};
+}
+
+outcome::result<std::vector<Cell>> MazeSolver::Solve(
+    const Cell& from, const Cell& to, SolverAlgorithm algorithm) {
+  const std::uint32_t start = OUTCOME_TRYX(graph_->index_of(from));
+  const std::uint32_t goal = OUTCOME_TRYX(graph_->index_of(to));
+
+  expanded_ = 0;
+  const bool found = algorithm == SolverAlgorithm::Bfs ? bfs(start, goal)
+                                                       : a_star(start, goal);
+  if (not found) return std::vector<Cell>{};
+  return path_to(start, goal);
+}
+
+bool MazeSolver::bfs(std::uint32_t from, std::uint32_t to) {
+  const auto steps = neighbour_steps(graph_->num_cols());
+  std::fill(parent_.begin(), parent_.end(), kNone);
+
+  parent_[from] = from;
+  queue_[0] = from;
+  std::size_t head = 0;
+  std::size_t tail = 1;
+  while (head < tail) {
+    const std::uint32_t cell = queue_[head++];
+    ++expanded_;
+    if (cell == to) return true;
+
+    const WallMask open = graph_->open(cell);
+    for (unsigned dir = 0; dir < 4; ++dir) {
+      if (not(open & (1u << dir))) continue;
+      const std::uint32_t next = cell + steps[dir];
+      if (parent_[next] != kNone) continue;
+      parent_[next] = cell;
+      queue_[tail++] = next;
+    }
+  }
+  return false;
+}
+
+// Heap entries pack f = g + h above the cell index, so a min-heap of plain
+// integers orders by f. Entries made stale by a shorter path are skipped.
+bool MazeSolver::a_star(std::uint32_t from, std::uint32_t to) {
+  const auto steps = neighbour_steps(graph_->num_cols());
+  const Cell goal = graph_->cell_at(to);
+  const auto heuristic = [this, &goal](std::uint32_t idx) {
+    const Cell cell = graph_->cell_at(idx);
+    return static_cast<std::uint32_t>(std::abs(cell.row - goal.row) +
+                                      std::abs(cell.col - goal.col));
+  };
+  const auto push = [this](std::uint32_t f, std::uint32_t idx) {
+    heap_.push_back(static_cast<std::uint64_t>(f) << 32 | idx);
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+  };
+
+  std::fill(parent_.begin(), parent_.end(), kNone);
+  std::fill(distance_.begin(), distance_.end(), kNone);
+  heap_.clear();
+
+  parent_[from] = from;
+  distance_[from] = 0;
+  push(heuristic(from), from);
+  while (not heap_.empty()) {
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+    const auto entry = heap_.back();
+    heap_.pop_back();
+    const auto cell = static_cast<std::uint32_t>(entry);
+    const auto f = static_cast<std::uint32_t>(entry >> 32);
+    if (f != distance_[cell] + heuristic(cell)) continue;
+    ++expanded_;
+    if (cell == to) return true;
+
+    const WallMask open = graph_->open(cell);
+    for (unsigned dir = 0; dir < 4; ++dir) {
+      if (not(open & (1u << dir))) continue;
+      const std::uint32_t next = cell + steps[dir];
+      const std::uint32_t g = distance_[cell] + 1;
+      if (g >= distance_[next]) continue;
+      distance_[next] = g;
+      parent_[next] = cell;
+      push(g + heuristic(next), next);
+    }
+  }
+  return false;
+}
+
+std::vector<Cell> MazeSolver::path_to(std::uint32_t from,
+                                      std::uint32_t to) const {
+  std::vector<Cell> path;
+  for (std::uint32_t cell = to; cell != from; cell = parent_[cell]) {
+    path.push_back(graph_->cell_at(cell));
+  }
+  path.push_back(graph_->cell_at(from));
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+outcome::result<std::vector<Cell>> SolveMaze(
+    const SquareRectangularMaze& maze,
+    const SquareRectangularMaze::ValidPosition& from,
+    const SquareRectangularMaze::ValidPosition& to, SolverAlgorithm algorithm) {
+  const MazeGraph graph = OUTCOME_TRYX(MazeGraph::Make(maze));
+  MazeSolver solver = OUTCOME_TRYX(MazeSolver::Make(graph));
+  return solver.Solve(Cell{from.row(), from.col()}, Cell{to.row(), to.col()},
+                      algorithm);
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <outcome.hpp>
+#include <vector>
+
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+struct Cell {
+  int row;
+  int col;
+
+  friend bool operator==(const Cell&, const Cell&) = default;
+};
+
+// Adjacency of a maze as one byte per cell, row-major: bit d of a cell is set
+// when the maze can be left through Direction d. Neighbours are found by index
+// arithmetic (+-1, +-num_cols), so searches need no per-node containers.
+class MazeGraph {
+  int num_rows_;
+  int num_cols_;
+  std::vector<WallMask> open_;
+
+  MazeGraph(int num_rows, int num_cols)
+      : num_rows_{num_rows},
+        num_cols_{num_cols},
+        open_(static_cast<std::size_t>(num_rows) *
+              static_cast<std::size_t>(num_cols)) {}
+
+ public:
+  static outcome::result<MazeGraph> Make(const SquareRectangularMaze& maze);
+  static outcome::result<MazeGraph> Make(const WallPlanes& walls);
+
+  int num_rows() const { return num_rows_; }
+  int num_cols() const { return num_cols_; }
+  std::size_t num_cells() const { return open_.size(); }
+
+  outcome::result<std::uint32_t> index_of(const Cell& cell) const {
+    if (cell.row < 0 || cell.row >= num_rows_ || cell.col < 0 ||
+        cell.col >= num_cols_) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+    return static_cast<std::uint32_t>(cell.row) *
+               static_cast<std::uint32_t>(num_cols_) +
+           static_cast<std::uint32_t>(cell.col);
+  }
+
+  Cell cell_at(std::uint32_t idx) const {
+    return Cell{static_cast<int>(idx / static_cast<std::uint32_t>(num_cols_)),
+                static_cast<int>(idx % static_cast<std::uint32_t>(num_cols_))};
+  }
+
+  // Open directions of cell `idx`; no bounds checking.
+  WallMask open(std::uint32_t idx) const { return open_[idx]; }
+};
+
+enum class SolverAlgorithm {
+  Bfs,
+  AStar,
+};
+
+// Shortest paths over a MazeGraph. The per-cell parent and distance arrays
+// are flat and owned by the solver, so repeated solves on the same graph do
+// not allocate. The graph must outlive the solver.
+class MazeSolver {
+  const MazeGraph* graph_;
+  std::vector<std::uint32_t> parent_;
+  std::vector<std::uint32_t> distance_;
+  std::vector<std::uint32_t> queue_;
+  std::vector<std::uint64_t> heap_;
+  std::size_t expanded_ = 0;
+
+  explicit MazeSolver(const MazeGraph& graph);
+
+ public:
+  static outcome::result<MazeSolver> Make(const MazeGraph& graph);
+
+  // Cells from `from` to `to`, both included; empty when `to` cannot be
+  // reached. A* uses the Manhattan distance as its heuristic.
+  outcome::result<std::vector<Cell>> Solve(
+      const Cell& from, const Cell& to,
+      SolverAlgorithm algorithm = SolverAlgorithm::Bfs);
+
+  // Cells taken off the open set by the last Solve().
+  std::size_t expanded() const { return expanded_; }
+
+ private:
+  bool bfs(std::uint32_t from, std::uint32_t to);
+  bool a_star(std::uint32_t from, std::uint32_t to);
+  std::vector<Cell> path_to(std::uint32_t from, std::uint32_t to) const;
+};
+
+// Solves `maze` once, building the graph on the way.
+outcome::result<std::vector<Cell>> SolveMaze(
+    const SquareRectangularMaze& maze,
+    const SquareRectangularMaze::ValidPosition& from,
+    const SquareRectangularMaze::ValidPosition& to,
+    SolverAlgorithm algorithm = SolverAlgorithm::Bfs);
+
+}  // namespace maze_walker
@@ -0,0 +1,88 @@
+#include "maze_solver.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdlib>
+
+#include "mazegen_growing_tree.hpp"
+
+namespace maze_walker {
+namespace {
+
+// Every step moves to a neighbour through an open wall.
+bool follows_passages(const SquareRectangularMaze& maze,
+                      const std::vector<Cell>& path) {
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    const Cell& a = path[i - 1];
+    const Cell& b = path[i];
+    if (std::abs(a.row - b.row) + std::abs(a.col - b.col) != 1) return false;
+    const auto walls = maze.walls(maze.make_position(a.row, a.col).value());
+    const std::size_t dir = b.row < a.row   ? 0
+                            : b.col > a.col ? 1
+                            : b.row > a.row ? 2
+                                            : 3;
+    if (walls[dir]) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST_CASE("BFS and A* find the unique path of a perfect maze",
+          "[maze_solver]") {
+  GrowingTreeOptions options;
+  options.seed = 21;
+  options.strategy = GENERATE(SelectionStrategy::Newest,
+                              SelectionStrategy::Random);
+  const auto maze =
+      SquareRectangularMaze::Make(GenerateMaze(41, 23, options).value())
+          .value();
+  const MazeGraph graph = MazeGraph::Make(maze).value();
+  MazeSolver solver = MazeSolver::Make(graph).value();
+
+  const Cell from{0, 0};
+  const Cell to{22, 40};
+  const auto bfs = solver.Solve(from, to, SolverAlgorithm::Bfs).value();
+  const auto bfs_expanded = solver.expanded();
+  const auto a_star = solver.Solve(from, to, SolverAlgorithm::AStar).value();
+
+  REQUIRE(bfs.front() == from);
+  REQUIRE(bfs.back() == to);
+  REQUIRE(follows_passages(maze, bfs));
+  REQUIRE(a_star == bfs);
+  REQUIRE(solver.expanded() <= bfs_expanded);
+
+  const auto direct = SolveMaze(maze, maze.make_position(0, 0).value(),
+                                maze.make_position(22, 40).value(),
+                                SolverAlgorithm::AStar)
+                          .value();
+  REQUIRE(direct == bfs);
+}
+
+TEST_CASE("Open grid paths are Manhattan-short", "[maze_solver]") {
+  const auto maze = SquareRectangularMaze::Make(10, 6).value();
+  const MazeGraph graph = MazeGraph::Make(maze).value();
+  MazeSolver solver = MazeSolver::Make(graph).value();
+
+  for (const auto algorithm : {SolverAlgorithm::Bfs, SolverAlgorithm::AStar}) {
+    const auto path = solver.Solve({5, 1}, {2, 8}, algorithm).value();
+    REQUIRE(path.size() == 3 + 7 + 1);
+    REQUIRE(follows_passages(maze, path));
+
+    REQUIRE(solver.Solve({3, 3}, {3, 3}, algorithm).value() ==
+            std::vector<Cell>{{3, 3}});
+  }
+}
+
+TEST_CASE("Solver reports unreachable cells and bad input", "[maze_solver]") {
+  const WallPlanes walls = WallPlanes::Make(4, 4).value();
+  const MazeGraph graph = MazeGraph::Make(walls).value();
+  MazeSolver solver = MazeSolver::Make(graph).value();
+
+  REQUIRE(solver.Solve({0, 0}, {3, 3}).value().empty());
+  REQUIRE(solver.Solve({0, 0}, {3, 3}, SolverAlgorithm::AStar)
+              .value()
+              .empty());
+  REQUIRE_FALSE(solver.Solve({0, 0}, {4, 0}));
+  REQUIRE_FALSE(solver.Solve({-1, 0}, {0, 0}));
+}
+}  // namespace maze_walker
@@ -0,0 +1,198 @@
+#include "maze_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+#include "maze_flood.hpp"
+#include "profile.hpp"
+
+namespace maze_walker {
+namespace {
+
+// Totals of one row band, merged once every band is done.
+struct BandStats {
+  std::array<std::size_t, 5> cells_by_openings{};
+  std::vector<std::size_t> corridor_lengths;
+  std::size_t ways_on = 0;
+};
+
+WallMask openings(const WallPlanes& walls, const Cell& cell) {
+  return static_cast<WallMask>(~CellWalls(walls, cell.row, cell.col) & 0xfu);
+}
+
+Cell step(const Cell& cell, unsigned direction) {
+  switch (static_cast<Direction>(direction)) {
+    case Direction::North:
+      return {cell.row - 1, cell.col};
+    case Direction::East:
+      return {cell.row, cell.col + 1};
+    case Direction::South:
+      return {cell.row + 1, cell.col};
+    case Direction::West:
+      break;
+  }
+  return {cell.row, cell.col - 1};
+}
+
+unsigned opposite(unsigned direction) { return (direction + 2) % 4; }
+
+bool before(const Cell& a, const Cell& b) {
+  return a.row < b.row || (a.row == b.row && a.col < b.col);
+}
+
+// Follows the corridor that leaves `start` in `direction` and records it,
+// unless it is the same corridor seen from its other end. Corridors only
+// contain cells with two openings, so the walk cannot branch or loop without
+// coming back to `start`.
+void walk_corridor(const WallPlanes& walls, const Cell& start,
+                   unsigned direction, BandStats& band) {
+  const unsigned first = direction;
+  Cell cell = start;
+  std::size_t length = 0;
+  for (;;) {
+    cell = step(cell, direction);
+    ++length;
+    const WallMask open = openings(walls, cell);
+    if (std::popcount(open) != 2) break;
+    direction = static_cast<unsigned>(
+        std::countr_zero(open & ~(1u << opposite(direction))));
+  }
+
+  const bool first_seen =
+      before(start, cell) || (cell == start && first < opposite(direction));
+  if (not first_seen) return;
+
+  if (band.corridor_lengths.size() <= length) {
+    band.corridor_lengths.resize(length + 1);
+  }
+  ++band.corridor_lengths[length];
+}
+
+BandStats analyze_band(const WallPlanes& walls, int row_begin, int row_end) {
+  BandStats band;
+  for (int row = row_begin; row < row_end; ++row) {
+    for (int col = 0; col < walls.num_cols(); ++col) {
+      const Cell cell{row, col};
+      const WallMask open = openings(walls, cell);
+      const auto count = static_cast<std::size_t>(std::popcount(open));
+      ++band.cells_by_openings[count];
+      if (count >= 2) band.ways_on += count - 1;
+      if (count == 2) continue;
+
+      for (unsigned dir = 0; dir < 4; ++dir) {
+        if (open & (1u << dir)) walk_corridor(walls, cell, dir, band);
+      }
+    }
+  }
+  return band;
+}
+
+// Splits the rows into one band per thread; the bands only read the walls.
+BandStats analyze_bands(const WallPlanes& walls, unsigned threads) {
+  const int rows = walls.num_rows();
+  std::vector<BandStats> bands(threads);
+  const auto band_rows = [&](unsigned band) {
+    return static_cast<int>(static_cast<long long>(rows) * band / threads);
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (unsigned i = 1; i < threads; ++i) {
+    workers.emplace_back([&, i] {
+      bands[i] = analyze_band(walls, band_rows(i), band_rows(i + 1));
+    });
+  }
+  bands[0] = analyze_band(walls, band_rows(0), band_rows(1));
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  BandStats total = std::move(bands[0]);
+  for (unsigned i = 1; i < threads; ++i) {
+    const BandStats& band = bands[i];
+    for (std::size_t n = 0; n < total.cells_by_openings.size(); ++n) {
+      total.cells_by_openings[n] += band.cells_by_openings[n];
+    }
+    if (total.corridor_lengths.size() < band.corridor_lengths.size()) {
+      total.corridor_lengths.resize(band.corridor_lengths.size());
+    }
+    for (std::size_t n = 0; n < band.corridor_lengths.size(); ++n) {
+      total.corridor_lengths[n] += band.corridor_lengths[n];
+    }
+    total.ways_on += band.ways_on;
+  }
+  return total;
+}
+
+double ratio(std::size_t numerator, std::size_t denominator) {
+  return denominator == 0 ? 0.0
+                          : static_cast<double>(numerator) /
+                                static_cast<double>(denominator);
+}
+
+outcome::result<MazeStats> analyze(WallPlanes walls,
+                                   const MazeStatsOptions& options) {
+  MAZE_PROFILE_SCOPE("stats.analyze");
+  const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned threads =
+      std::min(options.threads > 0 ? options.threads : hardware,
+               static_cast<unsigned>(walls.num_rows()));
+
+  MazeStats stats;
+  stats.num_rows = walls.num_rows();
+  stats.num_cols = walls.num_cols();
+
+  BandStats band = analyze_bands(walls, threads);
+  stats.cells_by_openings = band.cells_by_openings;
+  stats.corridor_lengths = std::move(band.corridor_lengths);
+  stats.branching_factor =
+      ratio(band.ways_on, stats.num_cells() - stats.cells_by_openings[0] -
+                              stats.cells_by_openings[1]);
+  stats.river_factor = ratio(stats.num_cells(), stats.dead_ends());
+
+  FloodFill flood = OUTCOME_TRYX(FloodFill::Make(std::move(walls)));
+  const Cell exit_cell{stats.num_rows - 1, stats.num_cols - 1};
+  std::uint32_t exit_distance = FloodFill::kUnreachable;
+  const FloodStats from_start =
+      OUTCOME_TRYX(flood.Run({0, 0}, exit_cell, exit_distance));
+  stats.connected = from_start.reached == stats.num_cells();
+  if (exit_distance != FloodFill::kUnreachable) {
+    stats.solution_length = exit_distance;
+  }
+
+  const FloodStats from_far = OUTCOME_TRYX(flood.Run(from_start.farthest));
+  stats.diameter = from_far.eccentricity;
+  stats.diameter_from = from_start.farthest;
+  stats.diameter_to = from_far.farthest;
+  return stats;
+}
+
+}  // namespace
+
+std::size_t MazeStats::num_corridors() const {
+  return std::accumulate(corridor_lengths.begin(), corridor_lengths.end(),
+                         std::size_t{0});
+}
+
+double MazeStats::mean_corridor_length() const {
+  std::size_t steps = 0;
+  for (std::size_t n = 0; n < corridor_lengths.size(); ++n) {
+    steps += n * corridor_lengths[n];
+  }
+  return ratio(steps, num_corridors());
+}
+
+outcome::result<MazeStats> AnalyzeMaze(const WallPlanes& walls,
+                                       const MazeStatsOptions& options) {
+  return analyze(walls, options);
+}
+
+outcome::result<MazeStats> AnalyzeMaze(const SquareRectangularMazeData& data,
+                                       const MazeStatsOptions& options) {
+  return analyze(OUTCOME_TRYX(FromMazeData(data)), options);
+}
+
+}  // namespace maze_walker
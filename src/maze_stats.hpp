@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <outcome.hpp>
+#include <vector>
+
+#include "maze_solver.hpp"
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+struct MazeStatsOptions {
+  unsigned threads = 0;  // 0 for one per core
+};
+
+// Quality metrics of a maze. A corridor is a run of cells with exactly two
+// openings; its length is the number of steps between the cells at either
+// end, which are dead ends or junctions.
+struct MazeStats {
+  int num_rows = 0;
+  int num_cols = 0;
+
+  // Cells by number of openings: isolated cells, dead ends, corridor cells,
+  // T-junctions and crossroads.
+  std::array<std::size_t, 5> cells_by_openings{};
+  // corridor_lengths[n] is the number of corridors of length n.
+  std::vector<std::size_t> corridor_lengths;
+
+  // Mean number of ways on from a cell that is not a dead end, i.e. the mean
+  // of openings - 1 over cells with at least two openings.
+  double branching_factor = 0;
+  // Cells per dead end. High for mazes with few long dead ends (the
+  // newest-cell growing tree), low for mazes with many short ones
+  // (random-cell).
+  double river_factor = 0;
+
+  // Steps from the top-left to the bottom-right cell, if they are connected.
+  std::optional<std::uint32_t> solution_length;
+  // Longest shortest path, by a double BFS: exact for perfect mazes, a lower
+  // bound otherwise. Measured within the component of the top-left cell.
+  std::uint32_t diameter = 0;
+  Cell diameter_from{0, 0};
+  Cell diameter_to{0, 0};
+  // Whether every cell can be reached from the top-left one.
+  bool connected = false;
+
+  std::size_t num_cells() const {
+    return static_cast<std::size_t>(num_rows) *
+           static_cast<std::size_t>(num_cols);
+  }
+  std::size_t dead_ends() const { return cells_by_openings[1]; }
+  std::size_t junctions() const {
+    return cells_by_openings[3] + cells_by_openings[4];
+  }
+  std::size_t num_corridors() const;
+  double mean_corridor_length() const;
+};
+
+// Computes the statistics in three passes: one over the adjacency of every
+// cell and the corridors that start at each dead end or junction, split into
+// row bands that run on separate threads, and two bit-parallel flood fills
+// for the solution and the diameter.
+outcome::result<MazeStats> AnalyzeMaze(const WallPlanes& walls,
+                                       const MazeStatsOptions& options = {});
+
+outcome::result<MazeStats> AnalyzeMaze(const SquareRectangularMazeData& data,
+                                       const MazeStatsOptions& options = {});
+
+}  // namespace maze_walker
@@ -0,0 +1,95 @@
+#include "maze_stats.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "maze_flood.hpp"
+#include "mazegen_growing_tree.hpp"
+
+namespace maze_walker {
+
+TEST_CASE("Statistics of a straight corridor", "[maze_stats]") {
+  WallPlanes walls = WallPlanes::Make(1, 5).value();
+  for (int col = 0; col < 4; ++col) {
+    walls.Carve(CarveEvent{0, col, Direction::East});
+  }
+  const MazeStats stats = AnalyzeMaze(walls).value();
+
+  REQUIRE(stats.dead_ends() == 2);
+  REQUIRE(stats.cells_by_openings[2] == 3);
+  REQUIRE(stats.junctions() == 0);
+  REQUIRE(stats.num_corridors() == 1);
+  REQUIRE(stats.corridor_lengths.size() == 5);
+  REQUIRE(stats.corridor_lengths[4] == 1);
+  REQUIRE(stats.branching_factor == 1.0);
+  REQUIRE(stats.river_factor == 2.5);
+  REQUIRE(stats.solution_length == 4u);
+  REQUIRE(stats.diameter == 4);
+  REQUIRE(stats.connected);
+}
+
+TEST_CASE("Statistics of a loop and a cut-off cell", "[maze_stats]") {
+  // A 2x2 ring next to a cell walled in on its own.
+  WallPlanes walls = WallPlanes::Make(2, 3).value();
+  walls.Carve(CarveEvent{0, 0, Direction::East});
+  walls.Carve(CarveEvent{0, 0, Direction::South});
+  walls.Carve(CarveEvent{1, 0, Direction::East});
+  walls.Carve(CarveEvent{0, 1, Direction::South});
+  walls.Carve(CarveEvent{0, 1, Direction::East});
+  const MazeStats stats = AnalyzeMaze(walls).value();
+
+  REQUIRE(stats.cells_by_openings[0] == 1);
+  REQUIRE(stats.dead_ends() == 1);
+  REQUIRE(stats.junctions() == 1);
+  // The ring counts once, from the junction back to itself.
+  REQUIRE(stats.corridor_lengths == std::vector<std::size_t>{0, 1, 0, 0, 1});
+  REQUIRE(not stats.connected);
+  REQUIRE(not stats.solution_length);
+}
+
+TEST_CASE("Statistics of generated mazes", "[maze_stats]") {
+  GrowingTreeOptions options;
+  options.seed = 17;
+  options.strategy =
+      GENERATE(SelectionStrategy::Newest, SelectionStrategy::Random);
+  const auto data = GenerateMaze(37, 29, options).value();
+  const WallPlanes walls = FromMazeData(data).value();
+
+  const MazeStats stats = AnalyzeMaze(data, {.threads = 1}).value();
+  REQUIRE(stats.num_rows == 29);
+  REQUIRE(stats.num_cols == 37);
+  REQUIRE(stats.connected);
+  REQUIRE(stats.cells_by_openings[0] == 0);
+
+  // Corridors split the passages of a perfect maze between them.
+  std::size_t steps = 0;
+  for (std::size_t n = 0; n < stats.corridor_lengths.size(); ++n) {
+    steps += n * stats.corridor_lengths[n];
+  }
+  REQUIRE(steps == stats.num_cells() - 1);
+
+  const MazeGraph graph = MazeGraph::Make(walls).value();
+  MazeSolver solver = MazeSolver::Make(graph).value();
+  const auto path = solver.Solve({0, 0}, {28, 36}).value();
+  REQUIRE(stats.solution_length == path.size() - 1);
+
+  // The double BFS finds the longest of all the eccentricities.
+  FloodFill flood = FloodFill::Make(walls).value();
+  std::uint32_t diameter = 0;
+  for (int row = 0; row < walls.num_rows(); ++row) {
+    for (int col = 0; col < walls.num_cols(); ++col) {
+      diameter =
+          std::max(diameter, flood.Run(Cell{row, col}).value().eccentricity);
+    }
+  }
+  REQUIRE(stats.diameter == diameter);
+  REQUIRE(solver.Solve(stats.diameter_from, stats.diameter_to).value().size() ==
+          diameter + 1);
+
+  const MazeStats banded = AnalyzeMaze(data, {.threads = 4}).value();
+  REQUIRE(banded.cells_by_openings == stats.cells_by_openings);
+  REQUIRE(banded.corridor_lengths == stats.corridor_lengths);
+  REQUIRE(banded.river_factor == stats.river_factor);
+  REQUIRE(banded.branching_factor == stats.branching_factor);
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,162 @@
+#include "maze_step_log.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <system_error>
+
+namespace maze_walker {
+namespace {
+
+constexpr std::size_t kMinKeyframeInterval = 1024;
+
+std::size_t plane_bytes(const util::BitGrid& plane) {
+  return static_cast<std::size_t>(plane.num_rows()) *
+         static_cast<std::size_t>(plane.words_per_row()) *
+         sizeof(util::BitGrid::Word);
+}
+
+// There is one snapshot per interval and the log costs 4 bytes per carve, so
+// an interval of a quarter of the snapshot's bytes keeps the two in balance.
+// Snapshot size is taken from the planes rather than the cell count since
+// every row is padded to a whole word: an N x 1 maze pays 64 bits per cell.
+std::size_t default_keyframe_interval(const WallPlanes& planes) {
+  const std::size_t snapshot_bytes =
+      plane_bytes(planes.wall_down) + plane_bytes(planes.wall_right);
+  return std::max(kMinKeyframeInterval,
+                  snapshot_bytes / sizeof(std::uint32_t));
+}
+
+}  // namespace
+
+MazeStepLog::MazeStepLog(int num_rows, int num_cols,
+                         std::size_t keyframe_interval, WallPlanes initial)
+    : num_rows_{num_rows},
+      num_cols_{num_cols},
+      keyframe_interval_{keyframe_interval},
+      current_{std::move(initial)} {}
+
+outcome::result<MazeStepLog> MazeStepLog::Make(int num_rows, int num_cols,
+                                               std::size_t keyframe_interval) {
+  WallPlanes initial = OUTCOME_TRYX(WallPlanes::Make(num_rows, num_cols));
+
+  const auto cells =
+      static_cast<std::size_t>(num_rows) * static_cast<std::size_t>(num_cols);
+  if (cells > std::numeric_limits<std::uint32_t>::max() >> 1) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+
+  if (keyframe_interval == 0) {
+    keyframe_interval = default_keyframe_interval(initial);
+  }
+
+  MazeStepLog log{num_rows, num_cols, keyframe_interval, std::move(initial)};
+  log.carves_.reserve(cells - 1);
+  return outcome::success(std::move(log));
+}
+
+outcome::result<void> MazeStepLog::Append(const CarveEvent& event) {
+  int row = event.row;
+  int col = event.col;
+  bool east = false;
+  switch (event.direction) {
+    case Direction::North:
+      row -= 1;
+      break;
+    case Direction::East:
+      east = true;
+      break;
+    case Direction::South:
+      break;
+    case Direction::West:
+      col -= 1;
+      east = true;
+      break;
+  }
+
+  if (row < 0 || col < 0 || row >= num_rows_ - (east ? 0 : 1) ||
+      col >= num_cols_ - (east ? 1 : 0)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  // A spanning tree opens each wall at most once and cells - 1 walls in
+  // all; anything more would skew the step numbering.
+  const util::BitGrid& plane = east ? current_.wall_right : current_.wall_down;
+  const std::size_t cells = static_cast<std::size_t>(num_rows_) *
+                            static_cast<std::size_t>(num_cols_);
+  if (not plane.test_bit(plane.bit_index(row, col)) ||
+      carves_.size() == cells - 1) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  const auto cell = static_cast<std::uint32_t>(row * num_cols_ + col);
+  carves_.push_back(cell << 1 | (east ? 1u : 0u));
+  current_.Carve(CarveEvent{row, col, east ? Direction::East : Direction::South});
+
+  if (carves_.size() % keyframe_interval_ == 0) {
+    keyframes_.push_back(current_);
+  }
+
+  return outcome::success();
+}
+
+CarveEvent MazeStepLog::carve(std::size_t idx) const {
+  const std::uint32_t encoded = carves_[idx];
+  const auto cell = static_cast<int>(encoded >> 1);
+  return CarveEvent{cell / num_cols_, cell % num_cols_,
+                    (encoded & 1u) ? Direction::East : Direction::South};
+}
+
+outcome::result<WallPlanes> MazeStepLog::MaterializeWalls(
+    std::size_t step) const {
+  if (step >= num_steps()) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  const std::size_t keyframe = step / keyframe_interval_;
+  WallPlanes walls = keyframe == 0
+                         ? OUTCOME_TRYX(WallPlanes::Make(num_rows_, num_cols_))
+                         : keyframes_[keyframe - 1];
+  replay(step, walls);
+  return walls;
+}
+
+outcome::result<void> MazeStepLog::MaterializeWalls(std::size_t step,
+                                                    WallPlanes& out) const {
+  if (step >= num_steps()) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  // Copy-assigning the planes keeps their word buffers when sizes match.
+  const std::size_t keyframe = step / keyframe_interval_;
+  if (keyframe > 0) {
+    out = keyframes_[keyframe - 1];
+  } else if (out.num_rows() == num_rows_ && out.num_cols() == num_cols_) {
+    out.Reset();
+  } else {
+    out = OUTCOME_TRYX(WallPlanes::Make(num_rows_, num_cols_));
+  }
+  replay(step, out);
+  return outcome::success();
+}
+
+// Carves the steps since the keyframe `walls` holds, up to `step`.
+void MazeStepLog::replay(std::size_t step, WallPlanes& walls) const {
+  const std::size_t keyframe = step / keyframe_interval_;
+  for (std::size_t idx = keyframe * keyframe_interval_; idx < step; ++idx) {
+    walls.Carve(carve(idx));
+  }
+}
+
+outcome::result<SquareRectangularMazeData> MazeStepLog::Materialize(
+    std::size_t step) const {
+  return ToMazeData(OUTCOME_TRYX(MaterializeWalls(step)));
+}
+
+outcome::result<void> MazeStepLog::Materialize(
+    std::size_t step, WallPlanes& scratch, SquareRectangularMazeData& out,
+    WallEncoding encoding) const {
+  OUTCOME_TRYV(MaterializeWalls(step, scratch));
+  return ToMazeData(scratch, out, encoding);
+}
+
+}  // namespace maze_walker
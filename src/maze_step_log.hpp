@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <outcome.hpp>
+#include <vector>
+
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// Record of a generation run as one carved wall per step. Step 0 is the fully
+// walled grid and step i has the first i walls carved. Each carve takes
+// 4 bytes. Every `keyframe_interval` steps the wall planes are also
+// snapshotted, so materialising a step replays at most that many carves.
+class MazeStepLog {
+  int num_rows_;
+  int num_cols_;
+  std::size_t keyframe_interval_;
+  // (cell << 1) | carved_east, with the wall attributed to the cell north
+  // or west of it.
+  std::vector<std::uint32_t> carves_;
+  std::vector<WallPlanes> keyframes_;
+  WallPlanes current_;
+
+  MazeStepLog(int num_rows, int num_cols, std::size_t keyframe_interval,
+              WallPlanes initial);
+
+ public:
+  // A keyframe interval of 0 picks one that keeps the snapshots (with their
+  // rows padded to 64-bit words) no larger than the carve log itself.
+  static outcome::result<MazeStepLog> Make(int num_rows, int num_cols,
+                                           std::size_t keyframe_interval = 0);
+
+  int num_rows() const { return num_rows_; }
+  int num_cols() const { return num_cols_; }
+  std::size_t keyframe_interval() const { return keyframe_interval_; }
+
+  std::size_t num_steps() const { return carves_.size() + 1; }
+
+  // Fails for walls outside the maze, walls already carved, and any carve
+  // past the cells - 1 of a spanning tree.
+  outcome::result<void> Append(const CarveEvent& event);
+
+  // The wall removed between step `idx` and `idx + 1`, normalised to the
+  // South or East wall of the cell that owns it.
+  CarveEvent carve(std::size_t idx) const;
+
+  outcome::result<SquareRectangularMazeData> Materialize(
+      std::size_t step) const;
+
+  // Materializes into `out`, replaying the carves in `scratch`; both reuse
+  // what they hold, so scrubbing through the steps allocates nothing once
+  // they have grown to the maze's size.
+  outcome::result<void> Materialize(
+      std::size_t step, WallPlanes& scratch, SquareRectangularMazeData& out,
+      WallEncoding encoding = WallEncoding::Repeated) const;
+
+  outcome::result<WallPlanes> MaterializeWalls(std::size_t step) const;
+
+  // Replays into `out`, reusing its storage when it already has the log's
+  // dimensions.
+  outcome::result<void> MaterializeWalls(std::size_t step,
+                                         WallPlanes& out) const;
+
+ private:
+  void replay(std::size_t step, WallPlanes& walls) const;
+};
+
+}  // namespace maze_walker
@@ -0,0 +1,92 @@
+#include "maze_step_log.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <utility>
+
+#include "mazegen_growing_tree.hpp"
+
+namespace maze_walker {
+TEST_CASE("Step log replays carved walls", "[maze_step_log]") {
+  MazeStepLog log = MazeStepLog::Make(2, 3).value();
+  REQUIRE(log.num_steps() == 1);
+
+  REQUIRE(log.Append(CarveEvent{0, 1, Direction::West}));
+  REQUIRE(log.Append(CarveEvent{1, 1, Direction::North}));
+  REQUIRE_FALSE(log.Append(CarveEvent{0, 2, Direction::East}));
+  REQUIRE_FALSE(log.Append(CarveEvent{0, 0, Direction::North}));
+  REQUIRE(log.num_steps() == 3);
+
+  REQUIRE(log.carve(0).row == 0);
+  REQUIRE(log.carve(0).col == 0);
+  REQUIRE(log.carve(0).direction == Direction::East);
+  REQUIRE(log.carve(1).direction == Direction::South);
+
+  const auto first = log.Materialize(1).value();
+  REQUIRE_FALSE(first.walls(0).e());
+  REQUIRE_FALSE(first.walls(1).w());
+  REQUIRE(first.walls(1).s());
+
+  const auto second = log.Materialize(2).value();
+  REQUIRE_FALSE(second.walls(1).s());
+  REQUIRE_FALSE(second.walls(4).n());
+
+  REQUIRE_FALSE(log.Materialize(3));
+}
+
+TEST_CASE("Step log rejects carves a spanning tree cannot make",
+          "[maze_step_log]") {
+  MazeStepLog log = MazeStepLog::Make(2, 2).value();
+  REQUIRE(log.Append(CarveEvent{0, 0, Direction::East}));
+  REQUIRE_FALSE(log.Append(CarveEvent{0, 1, Direction::West}));
+  REQUIRE(log.Append(CarveEvent{0, 0, Direction::South}));
+  REQUIRE(log.Append(CarveEvent{1, 1, Direction::North}));
+  REQUIRE(log.num_steps() == 4);
+
+  REQUIRE_FALSE(log.Append(CarveEvent{1, 0, Direction::East}));
+  REQUIRE(log.num_steps() == 4);
+}
+
+TEST_CASE("Default keyframes cost no more than the carve log",
+          "[maze_step_log]") {
+  // Row padding makes snapshots of narrow mazes far larger than 2 bits/cell.
+  for (const auto& [rows, cols] : {std::pair{256, 256}, std::pair{1 << 16, 1},
+                                  std::pair{1, 1 << 16}, std::pair{4096, 3}}) {
+    const MazeStepLog log = MazeStepLog::Make(rows, cols).value();
+    const auto cells = static_cast<std::size_t>(rows * cols);
+    const std::size_t words_per_row =
+        (static_cast<std::size_t>(cols) + 63) / 64;
+    const std::size_t snapshot_bytes =
+        2 * static_cast<std::size_t>(rows) * words_per_row * 8;
+    REQUIRE(cells / log.keyframe_interval() * snapshot_bytes <= 4 * cells);
+  }
+}
+
+TEST_CASE("Keyframes do not change materialised steps", "[maze_step_log]") {
+  const MazeStepLog generated = GenerateMazeWithSteps(9, 7).value();
+  MazeStepLog keyframed = MazeStepLog::Make(generated.num_rows(),
+                                            generated.num_cols(), 5)
+                              .value();
+  for (std::size_t idx = 0; idx + 1 < generated.num_steps(); ++idx) {
+    REQUIRE(keyframed.Append(generated.carve(idx)));
+  }
+
+  for (std::size_t step = 0; step < generated.num_steps(); ++step) {
+    REQUIRE(keyframed.Materialize(step).value().SerializeAsString() ==
+            generated.Materialize(step).value().SerializeAsString());
+  }
+
+  // Scrubbing back and forth keeps replaying into the same planes.
+  WallPlanes scratch =
+      WallPlanes::Make(generated.num_rows(), generated.num_cols()).value();
+  const auto* words = scratch.wall_down.words().data();
+  SquareRectangularMazeData data;
+  for (const std::size_t step : {std::size_t{62}, std::size_t{3},
+                                 std::size_t{40}, std::size_t{0}}) {
+    REQUIRE(keyframed.Materialize(step, scratch, data));
+    REQUIRE(data.SerializeAsString() ==
+            generated.Materialize(step).value().SerializeAsString());
+  }
+  REQUIRE(scratch.wall_down.words().data() == words);
+}
+}  // namespace maze_walker
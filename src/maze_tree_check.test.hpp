@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include "square_rectangular_maze.pb.h"
+
+namespace maze_walker {
+
+// Counts passages and cells reachable from (0, 0); a perfect maze has exactly
+// cells - 1 passages and reaches every cell.
+struct TreeCheck {
+  int passages = 0;
+  int reachable = 0;
+  bool symmetric = true;
+};
+
+inline TreeCheck check_tree(const SquareRectangularMazeData& data) {
+  const int rows = data.num_rows();
+  const int cols = data.num_cols();
+  TreeCheck result;
+
+  for (int idx = 0; idx < rows * cols; ++idx) {
+    const auto& cell = data.walls(idx);
+    if (idx % cols < cols - 1) {
+      result.passages += cell.e() ? 0 : 1;
+      result.symmetric &= cell.e() == data.walls(idx + 1).w();
+    }
+    if (idx / cols < rows - 1) {
+      result.passages += cell.s() ? 0 : 1;
+      result.symmetric &= cell.s() == data.walls(idx + cols).n();
+    }
+  }
+
+  std::vector<bool> seen(static_cast<std::size_t>(rows * cols), false);
+  std::vector<int> stack = {0};
+  seen[0] = true;
+  while (not stack.empty()) {
+    const int idx = stack.back();
+    stack.pop_back();
+    ++result.reachable;
+    const auto& cell = data.walls(idx);
+    const auto visit = [&](bool wall, int next) {
+      if (wall || seen[static_cast<std::size_t>(next)]) return;
+      seen[static_cast<std::size_t>(next)] = true;
+      stack.push_back(next);
+    };
+    if (idx / cols > 0) visit(cell.n(), idx - cols);
+    if (idx % cols < cols - 1) visit(cell.e(), idx + 1);
+    if (idx / cols < rows - 1) visit(cell.s(), idx + cols);
+    if (idx % cols > 0) visit(cell.w(), idx - 1);
+  }
+
+  return result;
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,121 @@
+#include "maze_validate.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <system_error>
+
+#include "disjoint_sets.hpp"
+#include "profile.hpp"
+
+namespace maze_walker {
+namespace {
+
+using util::DisjointSets;
+using index_type = DisjointSets::index_type;
+
+// Joins the cells on either side of a passage; fails if they were already
+// connected.
+outcome::result<void> join(DisjointSets& cells, index_type a, index_type b) {
+  if (not cells.unite(a, b)) {
+    return outcome::failure(std::errc::too_many_links);
+  }
+  return outcome::success();
+}
+
+outcome::result<void> check_connected(const DisjointSets& cells) {
+  if (cells.num_sets() != 1) {
+    return outcome::failure(std::errc::not_connected);
+  }
+  return outcome::success();
+}
+
+}  // namespace
+
+outcome::result<void> ValidatePerfectMaze(
+    const SquareRectangularMazeData& data) {
+  MAZE_PROFILE_SCOPE("validate.maze_data");
+  if (not HasWallsOfEveryCell(data)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  const int rows = data.num_rows();
+  const int cols = data.num_cols();
+  const auto has_wall = [&data](index_type cell, Direction dir) {
+    return (StoredWalls(data, static_cast<int>(cell)) & WallBit(dir)) != 0;
+  };
+
+  DisjointSets cells =
+      OUTCOME_TRYX(DisjointSets::Make(static_cast<std::size_t>(rows) *
+                                      static_cast<std::size_t>(cols)));
+  index_type idx = 0;
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col, ++idx) {
+      if (col < cols - 1) {
+        const bool east = has_wall(idx, Direction::East);
+        if (east != has_wall(idx + 1, Direction::West)) {
+          return outcome::failure(std::errc::illegal_byte_sequence);
+        }
+        if (not east) {
+          OUTCOME_TRYV(join(cells, idx, idx + 1));
+        }
+      }
+      if (row < rows - 1) {
+        const index_type below = idx + static_cast<index_type>(cols);
+        const bool south = has_wall(idx, Direction::South);
+        if (south != has_wall(below, Direction::North)) {
+          return outcome::failure(std::errc::illegal_byte_sequence);
+        }
+        if (not south) {
+          OUTCOME_TRYV(join(cells, idx, below));
+        }
+      }
+    }
+  }
+  return check_connected(cells);
+}
+
+// Walks the open walls a word at a time; the last column and the last row
+// are boundary walls and never open.
+outcome::result<void> ValidatePerfectMaze(const WallPlanes& walls) {
+  MAZE_PROFILE_SCOPE("validate.wall_planes");
+  using Word = util::BitGrid::Word;
+  constexpr int kBitsPerWord = util::BitGrid::kBitsPerWord;
+
+  const int rows = walls.num_rows();
+  const int cols = walls.num_cols();
+  DisjointSets cells = OUTCOME_TRYX(DisjointSets::Make(
+      static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols)));
+
+  const int words = walls.wall_right.words_per_row();
+  for (int row = 0; row < rows; ++row) {
+    const Word* right = walls.wall_right.row_words(row);
+    const Word* down = walls.wall_down.row_words(row);
+    const auto row_begin =
+        static_cast<index_type>(row) * static_cast<index_type>(cols);
+    for (int word = 0; word < words; ++word) {
+      const Word valid = walls.wall_right.valid_bits(word);
+      const auto word_begin =
+          row_begin + static_cast<index_type>(word * kBitsPerWord);
+
+      Word open_right = ~right[word] & valid;
+      if (word == words - 1) {
+        open_right &= ~(Word{1} << ((cols - 1) % kBitsPerWord));
+      }
+      for (; open_right != 0; open_right &= open_right - 1) {
+        const auto idx =
+            word_begin + static_cast<index_type>(std::countr_zero(open_right));
+        OUTCOME_TRYV(join(cells, idx, idx + 1));
+      }
+
+      if (row == rows - 1) continue;
+      for (Word open_down = ~down[word] & valid; open_down != 0;
+           open_down &= open_down - 1) {
+        const auto idx =
+            word_begin + static_cast<index_type>(std::countr_zero(open_down));
+        OUTCOME_TRYV(join(cells, idx, idx + static_cast<index_type>(cols)));
+      }
+    }
+  }
+  return check_connected(cells);
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <outcome.hpp>
+
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// Checks that `data` describes a perfect maze:
+//  - the dimensions are positive and match the stored walls, in either
+//    encoding, else std::errc::invalid_argument;
+//  - every inner wall is seen the same way from both of its cells, else
+//    std::errc::illegal_byte_sequence (the outer boundary is always closed,
+//    whatever its flags say, as in SquareRectangularMaze);
+//  - the passages form a spanning tree, i.e. there are no loops
+//    (std::errc::too_many_links) and every cell is connected
+//    (std::errc::not_connected).
+// One pass over the cells with a union-find over the passages: a passage
+// between two cells already connected closes a loop, and without loops the
+// maze is connected exactly when it has cells - 1 passages.
+outcome::result<void> ValidatePerfectMaze(
+    const SquareRectangularMazeData& data);
+
+// The spanning tree part of ValidatePerfectMaze for the bit-plane form, which
+// has no redundant walls to compare.
+outcome::result<void> ValidatePerfectMaze(const WallPlanes& walls);
+
+}  // namespace maze_walker
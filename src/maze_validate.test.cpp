@@ -0,0 +1,95 @@
+#include "maze_validate.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "mazegen_growing_tree.hpp"
+#include "mazegen_tiled.hpp"
+#include "square_rectangular_maze.hpp"
+
+namespace maze_walker {
+namespace {
+
+SquareRectangularMazeData generated_maze() {
+  GrowingTreeOptions options;
+  options.seed = 3;
+  return GenerateMaze(23, 17, options).value();
+}
+
+// A 3x3 snake: along the top row, down on the right, back along the middle
+// row, down on the left and along the bottom row.
+WallPlanes snake() {
+  WallPlanes walls = WallPlanes::Make(3, 3).value();
+  for (int row = 0; row < 3; ++row) {
+    walls.Carve(CarveEvent{row, 0, Direction::East});
+    walls.Carve(CarveEvent{row, 1, Direction::East});
+  }
+  walls.Carve(CarveEvent{0, 2, Direction::South});
+  walls.Carve(CarveEvent{1, 0, Direction::South});
+  return walls;
+}
+
+}  // namespace
+
+TEST_CASE("Generated mazes are perfect", "[maze_validate]") {
+  const auto data = generated_maze();
+  REQUIRE(ValidatePerfectMaze(data));
+  REQUIRE(ValidatePerfectMaze(FromMazeData(data).value()));
+  REQUIRE(SquareRectangularMaze::Make(data, MazeValidation::PerfectMaze));
+
+  const auto tiled = GenerateTiledWalls(150, 70, {}).value();
+  REQUIRE(ValidatePerfectMaze(tiled));
+  REQUIRE(ValidatePerfectMaze(ToMazeData(tiled).value()));
+}
+
+TEST_CASE("Validation rejects broken mazes", "[maze_validate]") {
+  auto data = generated_maze();
+
+  SECTION("Boundary flags are ignored") {
+    data.mutable_walls(0)->set_n(false);
+    data.mutable_walls(22)->set_e(false);
+    REQUIRE(ValidatePerfectMaze(data));
+  }
+
+  SECTION("Mismatched walls") {
+    auto* cell = data.mutable_walls(5 * 23 + 7);
+    cell->set_w(not cell->w());
+    REQUIRE(ValidatePerfectMaze(data).error() ==
+            std::errc::illegal_byte_sequence);
+    REQUIRE(SquareRectangularMaze::Make(data));
+    REQUIRE(SquareRectangularMaze::Make(data, MazeValidation::PerfectMaze)
+                .error() == std::errc::illegal_byte_sequence);
+  }
+
+  SECTION("A loop") {
+    WallPlanes walls = snake();
+    walls.Carve(CarveEvent{0, 0, Direction::South});
+    REQUIRE(ValidatePerfectMaze(walls).error() == std::errc::too_many_links);
+    REQUIRE(ValidatePerfectMaze(ToMazeData(walls).value()).error() ==
+            std::errc::too_many_links);
+  }
+
+  SECTION("Disconnected regions") {
+    WallPlanes walls = snake();
+    REQUIRE(ValidatePerfectMaze(walls));
+    walls.wall_down.set(walls.wall_down.MakeLocation(0, 2).value(), true);
+    REQUIRE(ValidatePerfectMaze(walls).error() == std::errc::not_connected);
+    REQUIRE(ValidatePerfectMaze(ToMazeData(walls).value()).error() ==
+            std::errc::not_connected);
+  }
+
+  SECTION("Wrong dimensions") {
+    data.set_num_cols(22);
+    REQUIRE(ValidatePerfectMaze(data).error() == std::errc::invalid_argument);
+  }
+
+  SECTION("Dimensions whose product overflows") {
+    data.set_num_cols(1 << 16);
+    data.set_num_rows(1 << 16);
+    REQUIRE(ValidatePerfectMaze(data).error() == std::errc::invalid_argument);
+    REQUIRE(FromMazeData(data).error() == std::errc::invalid_argument);
+    REQUIRE(SquareRectangularMaze::Make(data).error() ==
+            std::errc::invalid_argument);
+  }
+}
+
+}  // namespace maze_walker
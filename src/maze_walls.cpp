@@ -0,0 +1,342 @@
+#include "maze_walls.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <system_error>
+
+#include "profile.hpp"
+
+namespace maze_walker {
+
+outcome::result<WallPlanes> WallPlanes::Make(int num_rows, int num_cols) {
+  return WallPlanes{
+      OUTCOME_TRYX(util::BitGrid::Make(num_rows, num_cols, true)),
+      OUTCOME_TRYX(util::BitGrid::Make(num_rows, num_cols, true))};
+}
+
+void WallPlanes::Reset() {
+  wall_down.fill(true);
+  wall_right.fill(true);
+}
+
+void WallPlanes::Carve(const CarveEvent& event) {
+  const auto bit = wall_down.bit_index(event.row, event.col);
+  switch (event.direction) {
+    case Direction::North:
+      assert(event.row > 0);
+      wall_down.reset_bit(bit - wall_down.row_stride());
+      break;
+    case Direction::East:
+      assert(event.col < num_cols() - 1);
+      wall_right.reset_bit(bit);
+      break;
+    case Direction::South:
+      assert(event.row < num_rows() - 1);
+      wall_down.reset_bit(bit);
+      break;
+    case Direction::West:
+      assert(event.col > 0);
+      wall_right.reset_bit(bit - 1);
+      break;
+  }
+}
+
+WallMask CellWalls(const WallPlanes& walls, int row, int col) {
+  const auto idx = walls.wall_down.bit_index(row, col);
+  const auto stride = walls.wall_down.row_stride();
+  WallMask mask = 0;
+  if (row == 0 || walls.wall_down.test_bit(idx - stride)) {
+    mask |= WallBit(Direction::North);
+  }
+  if (col == walls.num_cols() - 1 || walls.wall_right.test_bit(idx)) {
+    mask |= WallBit(Direction::East);
+  }
+  if (row == walls.num_rows() - 1 || walls.wall_down.test_bit(idx)) {
+    mask |= WallBit(Direction::South);
+  }
+  if (col == 0 || walls.wall_right.test_bit(idx - 1)) {
+    mask |= WallBit(Direction::West);
+  }
+  return mask;
+}
+
+namespace {
+
+using Word = util::BitGrid::Word;
+
+static_assert(std::endian::native == std::endian::little,
+              "row masks are stored 8 cells to a little-endian word");
+
+// The four walls of 64 consecutive cells of a row, bit c for the cell in
+// column 64 * word + c, the outer boundary included.
+struct WallWords {
+  Word north;
+  Word east;
+  Word south;
+  Word west;
+};
+
+// Calls spread(words, out + column - first_col, cell count) for each word of
+// `row` from the one holding `first_col`, a multiple of 64, for as many cells
+// as `out` holds or up to the end of the row.
+template <typename Spread>
+void row_walls(const WallPlanes& walls, int row, int first_col,
+               std::span<WallMask> out, Spread spread) {
+  const int num_cols = walls.num_cols();
+  const Word* south = walls.wall_down.row_words(row);
+  const Word* north = row > 0 ? walls.wall_down.row_words(row - 1) : nullptr;
+  const Word* east = walls.wall_right.row_words(row);
+  const bool last_row = row == walls.num_rows() - 1;
+  const auto end_col = static_cast<int>(std::min<std::int64_t>(
+      num_cols, std::int64_t{first_col} + static_cast<std::int64_t>(out.size())));
+
+  int word = first_col / util::BitGrid::kBitsPerWord;
+  // West boundary of column 0, else the east wall of the column before.
+  Word carry =
+      word == 0 ? 1 : east[word - 1] >> (util::BitGrid::kBitsPerWord - 1);
+  for (; word * util::BitGrid::kBitsPerWord < end_col; ++word) {
+    const int first = word * util::BitGrid::kBitsPerWord;
+    const int count = std::min(util::BitGrid::kBitsPerWord, end_col - first);
+    WallWords words{
+        .north = north != nullptr ? north[word] : ~Word{0},
+        .east = east[word],
+        .south = last_row ? ~Word{0} : south[word],
+        // The west wall of a cell is the east wall of the cell before it.
+        .west = east[word] << 1 | carry,
+    };
+    carry = east[word] >> (util::BitGrid::kBitsPerWord - 1);
+    if (first + count == num_cols) words.east |= Word{1} << (count - 1);
+    spread(words, out.data() + (first - first_col), count);
+  }
+}
+
+// kSpreadBits[b] has bit i of b in the low bit of byte i.
+constexpr std::array<std::uint64_t, 256> kSpreadBits = [] {
+  std::array<std::uint64_t, 256> table{};
+  for (unsigned byte = 0; byte < table.size(); ++byte) {
+    for (unsigned bit = 0; bit < 8; ++bit) {
+      if (byte >> bit & 1u) table[byte] |= std::uint64_t{1} << (8 * bit);
+    }
+  }
+  return table;
+}();
+
+void spread_portable(const WallWords& words, WallMask* out, int count) {
+  for (int first = 0; first < count; first += 8) {
+    const auto spread = [first](Word plane) {
+      return kSpreadBits[plane >> first & 0xffu];
+    };
+    const std::uint64_t masks =
+        spread(words.north) << static_cast<unsigned>(Direction::North) |
+        spread(words.east) << static_cast<unsigned>(Direction::East) |
+        spread(words.south) << static_cast<unsigned>(Direction::South) |
+        spread(words.west) << static_cast<unsigned>(Direction::West);
+    std::memcpy(out + first, &masks,
+                static_cast<std::size_t>(std::min(8, count - first)));
+  }
+}
+
+#ifdef __AVX2__
+// Byte i of the result is `bit` where bit i of `bits` is set, 0 elsewhere.
+__m256i spread_bits_avx2(std::uint32_t bits, WallMask bit) {
+  // Byte i takes byte i / 8 of `bits`, then keeps only its bit i % 8.
+  const __m256i byte_of_cell =
+      _mm256_setr_epi64x(0x0000000000000000, 0x0101010101010101,
+                         0x0202020202020202, 0x0303030303030303);
+  const __m256i bit_of_cell = _mm256_set1_epi64x(
+      static_cast<std::int64_t>(0x8040201008040201));
+  const __m256i selected = _mm256_and_si256(
+      _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(bits)),
+                          byte_of_cell),
+      bit_of_cell);
+  return _mm256_and_si256(_mm256_cmpeq_epi8(selected, bit_of_cell),
+                          _mm256_set1_epi8(static_cast<char>(bit)));
+}
+
+void spread_avx2(const WallWords& words, WallMask* out, int count) {
+  for (int first = 0; first < count; first += 32) {
+    const auto bits = [first](Word plane) {
+      return static_cast<std::uint32_t>(plane >> first);
+    };
+    const __m256i masks = _mm256_or_si256(
+        _mm256_or_si256(
+            spread_bits_avx2(bits(words.north), WallBit(Direction::North)),
+            spread_bits_avx2(bits(words.east), WallBit(Direction::East))),
+        _mm256_or_si256(
+            spread_bits_avx2(bits(words.south), WallBit(Direction::South)),
+            spread_bits_avx2(bits(words.west), WallBit(Direction::West))));
+    if (count - first >= 32) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + first), masks);
+    } else {
+      alignas(32) WallMask tail[32];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(tail), masks);
+      std::memcpy(out + first, tail, static_cast<std::size_t>(count - first));
+    }
+  }
+}
+#endif
+
+void row_walls_from(const WallPlanes& walls, int row, int first_col,
+                    std::span<WallMask> out) {
+#ifdef __AVX2__
+  row_walls(walls, row, first_col, out, spread_avx2);
+#else
+  row_walls(walls, row, first_col, out, spread_portable);
+#endif
+}
+
+// ToMazeData converts a row this many cells at a time, so it needs no buffer
+// beyond the message it writes.
+constexpr int kChunkCells = 16 * util::BitGrid::kBitsPerWord;
+
+// Calls sink(mask) for every cell of the maze, in row-major order.
+template <typename Sink>
+void for_each_cell_walls(const WallPlanes& walls, Sink sink) {
+  std::array<WallMask, kChunkCells> chunk;
+  for (int row = 0; row < walls.num_rows(); ++row) {
+    for (int first = 0; first < walls.num_cols(); first += kChunkCells) {
+      const int count = std::min(kChunkCells, walls.num_cols() - first);
+      row_walls_from(walls, row, first, chunk);
+      for (int idx = 0; idx < count; ++idx) {
+        sink(chunk[static_cast<std::size_t>(idx)]);
+      }
+      // A short chunk ends the row; also keeps `first` from overflowing on
+      // rows close to INT_MAX wide.
+      if (count < kChunkCells) break;
+    }
+  }
+}
+
+}  // namespace
+
+void RowWalls(const WallPlanes& walls, int row, std::span<WallMask> out) {
+  row_walls_from(walls, row, 0, out);
+}
+
+void RowWallsPortable(const WallPlanes& walls, int row,
+                      std::span<WallMask> out) {
+  row_walls(walls, row, 0, out, spread_portable);
+}
+
+bool HasWallsOfEveryCell(const SquareRectangularMazeData& data) {
+  if (data.num_rows() <= 0 || data.num_cols() <= 0) return false;
+  const auto cells =
+      static_cast<std::int64_t>(data.num_rows()) * data.num_cols();
+  // Cells are indexed with int, as in ToMazeData. A packed message can
+  // describe more cells than that in under 2 GiB.
+  if (cells > INT_MAX) return false;
+  if (EncodingOf(data) == WallEncoding::Packed) {
+    return data.walls_size() == 0 &&
+           static_cast<std::int64_t>(data.packed_walls().size()) ==
+               (cells + 1) / 2;
+  }
+  return data.walls_size() == cells;
+}
+
+outcome::result<void> ToMazeData(const WallPlanes& walls,
+                                 SquareRectangularMazeData& out,
+                                 WallEncoding encoding) {
+  MAZE_PROFILE_SCOPE("walls.to_maze_data");
+  // A repeated field holds at most INT_MAX entries.
+  if (static_cast<std::int64_t>(walls.num_rows()) * walls.num_cols() >
+      INT_MAX) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+  const int cells = walls.num_rows() * walls.num_cols();
+  out.set_num_cols(walls.num_cols());
+  out.set_num_rows(walls.num_rows());
+
+  if (encoding == WallEncoding::Packed) {
+    out.clear_walls();
+    // The string keeps its capacity when reassigned.
+    std::string& bytes = *out.mutable_packed_walls();
+    bytes.assign(static_cast<std::size_t>(cells / 2 + cells % 2), '\0');
+    std::size_t cell = 0;
+    for_each_cell_walls(walls, [&bytes, &cell](WallMask mask) {
+      bytes[cell / 2] = static_cast<char>(
+          static_cast<unsigned char>(bytes[cell / 2]) | mask << (cell % 2 * 4));
+      ++cell;
+    });
+    return outcome::success();
+  }
+
+  // Every field of every cell is overwritten below, so cells left over from
+  // a previous maze are reused as they are; removed ones stay allocated for
+  // the next Add().
+  out.clear_packed_walls();
+  auto& cell_walls = *out.mutable_walls();
+  cell_walls.Reserve(cells);
+  while (cell_walls.size() > cells) cell_walls.RemoveLast();
+  while (cell_walls.size() < cells) cell_walls.Add();
+
+  int cell = 0;
+  for_each_cell_walls(walls, [&cell_walls, &cell](WallMask mask) {
+    auto* walls_of_cell = cell_walls.Mutable(cell++);
+    walls_of_cell->set_n(mask & WallBit(Direction::North));
+    walls_of_cell->set_e(mask & WallBit(Direction::East));
+    walls_of_cell->set_s(mask & WallBit(Direction::South));
+    walls_of_cell->set_w(mask & WallBit(Direction::West));
+  });
+  return outcome::success();
+}
+
+outcome::result<SquareRectangularMazeData> ToMazeData(const WallPlanes& walls,
+                                                      WallEncoding encoding) {
+  SquareRectangularMazeData maze;
+  OUTCOME_TRYV(ToMazeData(walls, maze, encoding));
+  return maze;
+}
+
+outcome::result<SquareRectangularMazeData*> ToMazeData(
+    const WallPlanes& walls, google::protobuf::Arena& arena,
+    WallEncoding encoding) {
+  auto* maze =
+      google::protobuf::Arena::CreateMessage<SquareRectangularMazeData>(
+          &arena);
+  OUTCOME_TRYV(ToMazeData(walls, *maze, encoding));
+  return maze;
+}
+
+outcome::result<WallPlanes> FromMazeData(
+    const SquareRectangularMazeData& data) {
+  MAZE_PROFILE_SCOPE("walls.from_maze_data");
+  // Checked before allocating: the dimensions of untrusted data can be
+  // anything, but the stored walls are bounded by the size of the input.
+  if (not HasWallsOfEveryCell(data)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  WallPlanes walls =
+      OUTCOME_TRYX(WallPlanes::Make(data.num_rows(), data.num_cols()));
+
+  int cell = 0;
+  for (int row = 0; row < walls.num_rows(); ++row) {
+    auto idx = walls.wall_down.bit_index(row, 0);
+    for (int col = 0; col < walls.num_cols(); ++col, ++idx, ++cell) {
+      // The outer boundary stays closed whatever the flags say.
+      const WallMask stored = StoredWalls(data, cell);
+      if (row + 1 < walls.num_rows() &&
+          not(stored & WallBit(Direction::South))) {
+        walls.wall_down.reset_bit(idx);
+      }
+      if (col + 1 < walls.num_cols() &&
+          not(stored & WallBit(Direction::East))) {
+        walls.wall_right.reset_bit(idx);
+      }
+    }
+  }
+
+  return walls;
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <google/protobuf/arena.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <outcome.hpp>
+#include <span>
+
+#include "bit_grid.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// Bit positions follow the NESW order used by SquareRectangularMaze::walls().
+enum class Direction : std::uint8_t {
+  North,
+  East,
+  South,
+  West,
+};
+
+// Walls of one cell as a 4-bit mask, bit i set when the wall in Direction i
+// stands; the same layout as the std::bitset from SquareRectangularMaze.
+using WallMask = std::uint8_t;
+
+constexpr WallMask WallBit(Direction dir) {
+  return static_cast<WallMask>(1u << static_cast<unsigned>(dir));
+}
+
+// A passage carved during generation: the wall between the cell at
+// (row, col) and its neighbour in `direction` was removed.
+struct CarveEvent {
+  int row;
+  int col;
+  Direction direction;
+};
+
+// South and east walls of every cell, one bit plane each. The north and west
+// walls of a cell are the south/east walls of its neighbours, and the outer
+// boundary is implicit, so this is the whole maze in 2 bits per cell.
+struct WallPlanes {
+  util::BitGrid wall_down;
+  util::BitGrid wall_right;
+
+  // All walls standing.
+  static outcome::result<WallPlanes> Make(int num_rows, int num_cols);
+
+  int num_rows() const { return wall_down.num_rows(); }
+  int num_cols() const { return wall_down.num_cols(); }
+
+  // Puts every wall back up, keeping the storage.
+  void Reset();
+
+  // Removes the wall described by `event`. The event must lie inside the
+  // grid and must not cross the outer boundary; this is not checked.
+  void Carve(const CarveEvent& event);
+};
+
+// All four walls of the cell at (row, col), the outer boundary included. No
+// bounds checking.
+WallMask CellWalls(const WallPlanes& walls, int row, int col);
+
+// CellWalls of every cell of `row`, into out[0, num_cols()). The masks are
+// built a 64-bit word of each plane at a time with shifts and ORs, then
+// spread to one byte per cell; with AVX2 (kRowWallsVectorized) 32 cells per
+// step, otherwise through a lookup table 8 cells per step. No bounds
+// checking; `out` must hold num_cols() masks.
+void RowWalls(const WallPlanes& walls, int row, std::span<WallMask> out);
+
+// The lookup-table kernel RowWalls falls back to without AVX2.
+void RowWallsPortable(const WallPlanes& walls, int row,
+                      std::span<WallMask> out);
+
+#ifdef __AVX2__
+inline constexpr bool kRowWallsVectorized = true;
+#else
+inline constexpr bool kRowWallsVectorized = false;
+#endif
+
+// How a SquareRectangularMazeData stores its walls, see the .proto.
+enum class WallEncoding {
+  Repeated,
+  Packed,
+};
+
+inline WallEncoding EncodingOf(const SquareRectangularMazeData& data) {
+  return data.packed_walls().empty() ? WallEncoding::Repeated
+                                     : WallEncoding::Packed;
+}
+
+// True when the dimensions are positive, there are at most INT_MAX cells and
+// `data` stores the walls of exactly that many cells, in one encoding. Row-
+// major cell indices of such a message fit in an int.
+bool HasWallsOfEveryCell(const SquareRectangularMazeData& data);
+
+// Walls of the cell at row-major index `cell` as stored in `data`, boundary
+// flags included. No bounds checking; see HasWallsOfEveryCell.
+inline WallMask StoredWalls(const SquareRectangularMazeData& data, int cell) {
+  if (EncodingOf(data) == WallEncoding::Packed) {
+    const auto byte = static_cast<unsigned char>(
+        data.packed_walls()[static_cast<std::size_t>(cell) / 2]);
+    return static_cast<WallMask>((byte >> (cell % 2 * 4)) & 0xfu);
+  }
+  const auto& walls = data.walls(cell);
+  return static_cast<WallMask>(
+      (walls.n() ? WallBit(Direction::North) : 0) |
+      (walls.e() ? WallBit(Direction::East) : 0) |
+      (walls.s() ? WallBit(Direction::South) : 0) |
+      (walls.w() ? WallBit(Direction::West) : 0));
+}
+
+outcome::result<SquareRectangularMazeData> ToMazeData(
+    const WallPlanes& walls, WallEncoding encoding = WallEncoding::Repeated);
+
+// Overwrites `out` with the maze. Sub-messages and buffers `out` already
+// holds are reused, so converting mazes of the same size into the same
+// message allocates nothing after the first time.
+outcome::result<void> ToMazeData(
+    const WallPlanes& walls, SquareRectangularMazeData& out,
+    WallEncoding encoding = WallEncoding::Repeated);
+
+// Builds the message on `arena`, which owns it: one allocation per arena
+// block instead of one per cell.
+outcome::result<SquareRectangularMazeData*> ToMazeData(
+    const WallPlanes& walls, google::protobuf::Arena& arena,
+    WallEncoding encoding = WallEncoding::Repeated);
+
+// Inverse of ToMazeData, for either encoding. Only the south and east walls
+// of every cell are read; the north/west flags are assumed to mirror them.
+outcome::result<WallPlanes> FromMazeData(const SquareRectangularMazeData& data);
+
+}  // namespace maze_walker
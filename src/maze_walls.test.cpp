@@ -0,0 +1,135 @@
+#include "maze_walls.hpp"
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "maze_validate.hpp"
+#include "mazegen_growing_tree.hpp"
+#include "random.hpp"
+#include "square_rectangular_maze.hpp"
+
+namespace maze_walker {
+namespace {
+
+WallPlanes generated_walls(int cols, int rows) {
+  GrowingTreeOptions options;
+  options.seed = 21;
+  return FromMazeData(GenerateMaze(cols, rows, options).value()).value();
+}
+
+// Every bit of both planes random, the boundary bits included, so the row
+// kernel has to close the outer boundary itself.
+WallPlanes random_walls(int rows, int cols, std::uint64_t seed) {
+  util::Xoshiro256 random{seed};
+  WallPlanes walls = WallPlanes::Make(rows, cols).value();
+  for (util::BitGrid* plane : {&walls.wall_down, &walls.wall_right}) {
+    for (int row = 0; row < rows; ++row) {
+      auto* words = plane->row_words(row);
+      for (int word = 0; word < plane->words_per_row(); ++word) {
+        words[word] = random() & plane->valid_bits(word);
+      }
+    }
+  }
+  return walls;
+}
+
+}  // namespace
+
+TEST_CASE("Row kernels match CellWalls bit for bit", "[maze_walls]") {
+  const int cols = GENERATE(1, 7, 31, 32, 33, 63, 64, 65, 127, 200);
+  const int rows = GENERATE(1, 2, 5);
+  const WallPlanes walls =
+      random_walls(rows, cols, static_cast<std::uint64_t>(7 * cols + rows));
+
+  std::vector<WallMask> kernel(static_cast<std::size_t>(cols));
+  std::vector<WallMask> portable(static_cast<std::size_t>(cols));
+  for (int row = 0; row < rows; ++row) {
+    RowWalls(walls, row, kernel);
+    RowWallsPortable(walls, row, portable);
+    for (int col = 0; col < cols; ++col) {
+      INFO("row " << row << ", col " << col);
+      REQUIRE(kernel[static_cast<std::size_t>(col)] ==
+              CellWalls(walls, row, col));
+      REQUIRE(portable[static_cast<std::size_t>(col)] ==
+              CellWalls(walls, row, col));
+    }
+  }
+}
+
+TEST_CASE("Packed and repeated wall encodings agree", "[maze_walls]") {
+  const int cols = GENERATE(1, 2, 7, 64, 1024, 1100);
+  const int rows = GENERATE(1, 5);
+  const WallPlanes walls = generated_walls(cols, rows);
+
+  const auto repeated = ToMazeData(walls).value();
+  const auto packed = ToMazeData(walls, WallEncoding::Packed).value();
+  REQUIRE(EncodingOf(repeated) == WallEncoding::Repeated);
+  REQUIRE(EncodingOf(packed) == WallEncoding::Packed);
+  REQUIRE(packed.walls_size() == 0);
+  REQUIRE(packed.packed_walls().size() ==
+          static_cast<std::size_t>((rows * cols + 1) / 2));
+  REQUIRE(HasWallsOfEveryCell(packed));
+
+  const auto maze = SquareRectangularMaze::Make(packed).value();
+  for (int cell = 0; cell < rows * cols; ++cell) {
+    const int row = cell / cols;
+    const int col = cell % cols;
+    REQUIRE(StoredWalls(packed, cell) == StoredWalls(repeated, cell));
+    REQUIRE(StoredWalls(packed, cell) == CellWalls(walls, row, col));
+    REQUIRE(maze.walls(maze.make_position(row, col).value()).to_ulong() ==
+            CellWalls(walls, row, col));
+  }
+
+  REQUIRE(ValidatePerfectMaze(packed));
+  const WallPlanes decoded = FromMazeData(packed).value();
+  REQUIRE(ToMazeData(decoded).value().SerializeAsString() ==
+          repeated.SerializeAsString());
+}
+
+TEST_CASE("Messages are reused across conversions", "[maze_walls]") {
+  const auto encoding = GENERATE(WallEncoding::Repeated, WallEncoding::Packed);
+  const WallPlanes large = generated_walls(9, 8);
+  const WallPlanes small = generated_walls(3, 4);
+
+  SquareRectangularMazeData out;
+  REQUIRE(ToMazeData(large, out, encoding));
+  REQUIRE(ToMazeData(small, out, encoding));
+  REQUIRE(out.SerializeAsString() ==
+          ToMazeData(small, encoding).value().SerializeAsString());
+
+  // Switching encodings leaves nothing of the other one behind.
+  const auto other = encoding == WallEncoding::Packed ? WallEncoding::Repeated
+                                                      : WallEncoding::Packed;
+  REQUIRE(ToMazeData(large, out, other));
+  REQUIRE(HasWallsOfEveryCell(out));
+  REQUIRE(out.SerializeAsString() ==
+          ToMazeData(large, other).value().SerializeAsString());
+}
+
+TEST_CASE("Messages can be built on an arena", "[maze_walls]") {
+  const WallPlanes walls = generated_walls(12, 10);
+  google::protobuf::Arena arena;
+  SquareRectangularMazeData* maze = ToMazeData(walls, arena).value();
+  REQUIRE(maze->GetArena() == &arena);
+  REQUIRE(maze->SerializeAsString() ==
+          ToMazeData(walls).value().SerializeAsString());
+}
+
+TEST_CASE("Malformed packed walls are rejected", "[maze_walls]") {
+  auto data = ToMazeData(generated_walls(5, 3), WallEncoding::Packed).value();
+
+  SECTION("Wrong length") {
+    data.mutable_packed_walls()->push_back('\0');
+    REQUIRE_FALSE(HasWallsOfEveryCell(data));
+    REQUIRE(FromMazeData(data).error() == std::errc::invalid_argument);
+    REQUIRE_FALSE(SquareRectangularMaze::Make(data));
+  }
+
+  SECTION("Both encodings at once") {
+    data.add_walls();
+    REQUIRE_FALSE(HasWallsOfEveryCell(data));
+    REQUIRE(ValidatePerfectMaze(data).error() == std::errc::invalid_argument);
+  }
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,393 @@
+#include <docopt/docopt.h>
+#include <fmt/format.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/delimited_message_util.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <outcome.hpp>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "maze_stats.hpp"
+#include "mazegen_growing_tree.hpp"
+#include "profile.hpp"
+#include "random.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+constexpr auto kUsage = R"(mazegen_cli - headless batch maze generation.
+
+Writes the mazes to <output> as length-delimited SquareRectangularMazeData
+records, in order. Maze i is generated from a seed derived from --seed and i,
+so the output does not depend on the number of threads.
+
+The stats command reads such files back and prints the quality metrics of
+every maze, followed by the means over each file.
+
+Usage:
+  mazegen_cli stats [--threads=<n>] <input>...
+  mazegen_cli [options] <output>
+  mazegen_cli (-h | --help)
+
+Options:
+  -h --help           Show this screen.
+  --rows=<n>          Rows per maze [default: 64].
+  --cols=<n>          Columns per maze [default: 64].
+  --count=<n>         Number of mazes [default: 1].
+  --seed=<n>          Base seed [default: 0].
+  --threads=<n>       Worker threads, 0 for one per core, at most 4 per
+                      core [default: 0].
+  --strategy=<name>   newest, oldest, random or mixed [default: newest].
+  --packed            Store the walls as packed_walls, 4 bits per cell.
+)";
+
+struct BatchConfig {
+  std::string output;
+  int num_rows;
+  int num_cols;
+  std::size_t count;
+  std::uint64_t seed;
+  unsigned threads;
+  SelectionStrategy strategy;
+  WallEncoding encoding;
+};
+
+outcome::result<SelectionStrategy> ParseStrategy(const std::string& name) {
+  if (name == "newest") return SelectionStrategy::Newest;
+  if (name == "oldest") return SelectionStrategy::Oldest;
+  if (name == "random") return SelectionStrategy::Random;
+  if (name == "mixed") return SelectionStrategy::Mixed;
+  return outcome::failure(std::errc::invalid_argument);
+}
+
+using ParsedArgs = std::map<std::string, docopt::value>;
+
+// docopt throws on values that are not numbers, e.g. --rows=abc.
+outcome::result<long> ParseLong(const ParsedArgs& parsed,
+                                const std::string& name) {
+  try {
+    return parsed.at(name).asLong();
+  } catch (const std::exception&) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+}
+
+// More workers than this per core only add contention, so larger --threads
+// values are rejected rather than spawned.
+constexpr unsigned kMaxThreadsPerCore = 4;
+
+unsigned HardwareThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// --threads, 0 included, up to kMaxThreadsPerCore per core.
+outcome::result<unsigned> ParseThreads(const ParsedArgs& parsed) {
+  const long threads = OUTCOME_TRYX(ParseLong(parsed, "--threads"));
+  if (threads < 0 ||
+      threads > static_cast<long>(kMaxThreadsPerCore * HardwareThreads())) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  return static_cast<unsigned>(threads);
+}
+
+outcome::result<BatchConfig> MakeBatchConfig(const ParsedArgs& parsed) {
+  constexpr long kMaxSide = std::numeric_limits<int>::max();
+  const long rows = OUTCOME_TRYX(ParseLong(parsed, "--rows"));
+  const long cols = OUTCOME_TRYX(ParseLong(parsed, "--cols"));
+  const long count = OUTCOME_TRYX(ParseLong(parsed, "--count"));
+  const long seed = OUTCOME_TRYX(ParseLong(parsed, "--seed"));
+  if (rows <= 0 || cols <= 0 || rows > kMaxSide || cols > kMaxSide ||
+      count < 0 || seed < 0) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  const unsigned threads = OUTCOME_TRYX(ParseThreads(parsed));
+
+  BatchConfig config;
+  config.output = parsed.at("<output>").asString();
+  config.num_rows = static_cast<int>(rows);
+  config.num_cols = static_cast<int>(cols);
+  config.count = static_cast<std::size_t>(count);
+  config.seed = static_cast<std::uint64_t>(seed);
+  config.threads = threads > 0 ? threads : HardwareThreads();
+  config.strategy =
+      OUTCOME_TRYX(ParseStrategy(parsed.at("--strategy").asString()));
+  config.encoding = parsed.at("--packed").asBool() ? WallEncoding::Packed
+                                                   : WallEncoding::Repeated;
+  return config;
+}
+
+// Hands out maze indices to the workers and collects their serialised
+// records so they can be written in index order. Workers stall when they run
+// too far ahead of the writer, which bounds the memory held in flight.
+class OrderedBatch {
+  std::size_t count_;
+  std::size_t window_;
+  std::atomic<std::size_t> next_index_{0};
+
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::map<std::size_t, std::string> finished_;
+  std::size_t written_ = 0;
+  std::optional<std::error_code> error_;
+
+ public:
+  OrderedBatch(std::size_t count, std::size_t window)
+      : count_{count}, window_{window} {}
+
+  std::optional<std::size_t> Claim() {
+    const std::size_t index = next_index_.fetch_add(1);
+    if (index >= count_) return std::nullopt;
+
+    std::unique_lock lock{mutex_};
+    changed_.wait(lock,
+                  [&] { return index < written_ + window_ || error_; });
+    if (error_) return std::nullopt;
+    return index;
+  }
+
+  void Finish(std::size_t index, std::string record) {
+    {
+      std::lock_guard lock{mutex_};
+      finished_.emplace(index, std::move(record));
+    }
+    changed_.notify_all();
+  }
+
+  void Fail(std::error_code error) {
+    {
+      std::lock_guard lock{mutex_};
+      if (not error_) error_ = error;
+    }
+    changed_.notify_all();
+  }
+
+  // Writes records as they become available, in order. Returns once every
+  // record has been written, a worker failed or a write failed; a failed
+  // write also stops the workers.
+  outcome::result<void> Drain(std::ostream& out) {
+    std::unique_lock lock{mutex_};
+    while (written_ < count_) {
+      changed_.wait(lock, [&] {
+        return finished_.count(written_) != 0 || error_.has_value();
+      });
+      if (error_) return outcome::failure(*error_);
+
+      auto node = finished_.extract(written_);
+      lock.unlock();
+      out.write(node.mapped().data(),
+                static_cast<std::streamsize>(node.mapped().size()));
+      if (not out) {
+        Fail(std::make_error_code(std::errc::io_error));
+        return outcome::failure(std::errc::io_error);
+      }
+      lock.lock();
+
+      ++written_;
+      changed_.notify_all();
+    }
+    lock.unlock();
+
+    if (not out.flush()) return outcome::failure(std::errc::io_error);
+    return outcome::success();
+  }
+};
+
+// `maze` is the worker's scratch message, reused from one maze to the next.
+outcome::result<std::string> GenerateRecord(const BatchConfig& config,
+                                             std::size_t index,
+                                             SquareRectangularMazeData& maze) {
+  GrowingTreeOptions options;
+  options.strategy = config.strategy;
+  options.seed = util::DeriveSeed(config.seed, index);
+
+  OUTCOME_TRYV(GenerateMaze(config.num_cols, config.num_rows, options, maze,
+                            config.encoding));
+
+  MAZE_PROFILE_SCOPE("cli.serialize");
+  std::string record;
+  google::protobuf::io::StringOutputStream stream{&record};
+  if (not google::protobuf::util::SerializeDelimitedToZeroCopyStream(
+          maze, &stream)) {
+    return outcome::failure(std::errc::io_error);
+  }
+  return record;
+}
+
+outcome::result<void> RunBatch(const BatchConfig& config) {
+  std::ofstream out{config.output, std::ios::binary | std::ios::trunc};
+  if (not out) {
+    return outcome::failure(std::errc::io_error);
+  }
+
+  OrderedBatch batch{config.count, 4 * std::size_t{config.threads}};
+
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  workers.reserve(config.threads);
+  for (unsigned i = 0; i < config.threads; ++i) {
+    workers.emplace_back([&] {
+      SquareRectangularMazeData maze;
+      while (const auto index = batch.Claim()) {
+        auto record = GenerateRecord(config, *index, maze);
+        if (not record) {
+          batch.Fail(record.error());
+          return;
+        }
+        batch.Finish(*index, std::move(record).value());
+      }
+    });
+  }
+
+  const auto drained = batch.Drain(out);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  OUTCOME_TRYV(drained);
+
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const double seconds = std::max(elapsed.count(), 1e-9);
+  const double mazes = static_cast<double>(config.count);
+  const double cells = mazes * config.num_rows * config.num_cols;
+  spdlog::info("generated {} {}x{} mazes on {} threads in {:.3f}s", config.count,
+               config.num_rows, config.num_cols, config.threads, seconds);
+  spdlog::info("{:.1f} mazes/s, {:.3g} cells/s", mazes / seconds,
+               cells / seconds);
+
+  return outcome::success();
+}
+
+void PrintStatsHeader() {
+  fmt::print("{:>12} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}\n",
+             "maze", "dead ends", "junctions", "corridors", "corr len",
+             "branching", "river", "solution", "diameter");
+}
+
+void PrintStats(const std::string& name, const MazeStats& stats) {
+  const auto solution =
+      stats.solution_length ? fmt::format("{}", *stats.solution_length)
+                            : std::string{"-"};
+  fmt::print("{:>12} {:>9} {:>9} {:>9} {:>9.2f} {:>9.3f} {:>9.2f} {:>9} {:>9}\n",
+             name, stats.dead_ends(), stats.junctions(), stats.num_corridors(),
+             stats.mean_corridor_length(), stats.branching_factor,
+             stats.river_factor, solution, stats.diameter);
+}
+
+// Running sums of the per-maze metrics, for the summary line.
+struct StatsTotals {
+  std::size_t mazes = 0;
+  double dead_ends = 0;
+  double junctions = 0;
+  double corridors = 0;
+  double corridor_length = 0;
+  double branching = 0;
+  double river = 0;
+  double diameter = 0;
+
+  void Add(const MazeStats& stats) {
+    ++mazes;
+    dead_ends += static_cast<double>(stats.dead_ends());
+    junctions += static_cast<double>(stats.junctions());
+    corridors += static_cast<double>(stats.num_corridors());
+    corridor_length += stats.mean_corridor_length();
+    branching += stats.branching_factor;
+    river += stats.river_factor;
+    diameter += stats.diameter;
+  }
+
+  void Print() const {
+    const double n = static_cast<double>(std::max<std::size_t>(mazes, 1));
+    fmt::print(
+        "{:>12} {:>9.1f} {:>9.1f} {:>9.1f} {:>9.2f} {:>9.3f} {:>9.2f} {:>9} "
+        "{:>9.1f}\n",
+        "mean", dead_ends / n, junctions / n, corridors / n,
+        corridor_length / n, branching / n, river / n, "", diameter / n);
+  }
+};
+
+outcome::result<void> RunStats(const std::vector<std::string>& inputs,
+                               const MazeStatsOptions& options) {
+  PrintStatsHeader();
+  for (const auto& input : inputs) {
+    std::ifstream in{input, std::ios::binary};
+    if (not in) {
+      return outcome::failure(std::errc::no_such_file_or_directory);
+    }
+    google::protobuf::io::IstreamInputStream stream{&in};
+    StatsTotals totals;
+
+    // Delimited parsing merges into the message, so it is cleared first;
+    // clearing keeps the cells allocated for the next record.
+    SquareRectangularMazeData maze;
+    for (std::size_t index = 0;; ++index) {
+      bool clean_eof = false;
+      bool parsed = false;
+      {
+        maze.Clear();
+        MAZE_PROFILE_SCOPE("cli.parse");
+        parsed = google::protobuf::util::ParseDelimitedFromZeroCopyStream(
+            &maze, &stream, &clean_eof);
+      }
+      if (not parsed) {
+        if (clean_eof) break;
+        return outcome::failure(std::errc::illegal_byte_sequence);
+      }
+      const MazeStats stats = OUTCOME_TRYX(AnalyzeMaze(maze, options));
+      PrintStats(fmt::format("{}x{} #{}", stats.num_rows, stats.num_cols, index),
+                 stats);
+      totals.Add(stats);
+    }
+    if (totals.mazes > 1) totals.Print();
+  }
+  return outcome::success();
+}
+
+// Totals of the hot-path timers and counters; nothing unless built with
+// ENABLE_PROFILING.
+void LogProfile() {
+  for (const util::ProfileEntry& entry : util::ProfileSnapshot()) {
+    spdlog::info("profile {}", util::FormatProfileEntry(entry));
+  }
+}
+
+outcome::result<void> Main(const std::vector<std::string>& args) {
+  const ParsedArgs parsed = docopt::docopt(kUsage, args, true);
+  if (parsed.at("stats").asBool()) {
+    MazeStatsOptions options;
+    options.threads = OUTCOME_TRYX(ParseThreads(parsed));
+    return RunStats(parsed.at("<input>").asStringList(), options);
+  }
+
+  const BatchConfig config = OUTCOME_TRYX(MakeBatchConfig(parsed));
+  return RunBatch(config);
+}
+
+}  // namespace maze_walker
+
+int main(int argc, const char** argv) {
+  std::vector<std::string> args = {std::next(argv), std::next(argv, argc)};
+  auto result = maze_walker::Main(args);
+  maze_walker::LogProfile();
+  if (not result) {
+    spdlog::error("mazegen_cli failed: {}", result.error().message());
+    return 1;
+  }
+  return 0;
+}
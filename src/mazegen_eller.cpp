@@ -0,0 +1,155 @@
+#include "mazegen_eller.hpp"
+
+#include <limits>
+#include <system_error>
+
+namespace maze_walker {
+namespace {
+
+bool is_probability(double p) { return p >= 0.0 && p <= 1.0; }
+
+}  // namespace
+
+EllerGenerator::EllerGenerator(const EllerOptions& options, std::uint64_t seed,
+                               int num_cols)
+    : options_{options},
+      rng_{seed},
+      num_cols_{num_cols},
+      labels_(static_cast<std::size_t>(num_cols)),
+      parent_(static_cast<std::size_t>(num_cols)),
+      label_root_(2 * static_cast<std::size_t>(num_cols), -1),
+      cells_left_(static_cast<std::size_t>(num_cols), 0),
+      carried_down_(static_cast<std::size_t>(num_cols), false),
+      open_north_(static_cast<std::size_t>(num_cols), false),
+      open_east_(static_cast<std::size_t>(num_cols), false),
+      open_south_(static_cast<std::size_t>(num_cols), false),
+      row_(static_cast<std::size_t>(num_cols), 0) {
+  for (int col = 0; col < num_cols_; ++col) {
+    labels_[static_cast<std::size_t>(col)] = num_cols_ + col;
+  }
+}
+
+outcome::result<EllerGenerator> EllerGenerator::Make(
+    int num_cols, const EllerOptions& options) {
+  if (num_cols <= 0 || not is_probability(options.merge_probability) ||
+      not is_probability(options.down_probability)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  // Fresh set labels go up to 2 * num_cols - 1, see labels_.
+  if (num_cols > std::numeric_limits<int>::max() / 2) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+
+  const std::uint64_t seed =
+      options.seed ? *options.seed : util::RandomDeviceSeed();
+  return EllerGenerator{options, seed, num_cols};
+}
+
+std::span<const WallMask> EllerGenerator::NextRow() {
+  start_row();
+  join_horizontally(false);
+  carve_down();
+  return emit_row(false);
+}
+
+std::span<const WallMask> EllerGenerator::LastRow() {
+  start_row();
+  join_horizontally(true);
+  open_south_.assign(open_south_.size(), false);
+  return emit_row(true);
+}
+
+// Rebuilds the union-find of the row from the set labels: every cell points
+// at the first cell of its set.
+void EllerGenerator::start_row() {
+  for (std::size_t col = 0; col < labels_.size(); ++col) {
+    auto& root = label_root_[static_cast<std::size_t>(labels_[col])];
+    if (root < 0) root = static_cast<int>(col);
+    parent_[col] = root;
+  }
+  for (const int label : labels_) {
+    label_root_[static_cast<std::size_t>(label)] = -1;
+  }
+}
+
+int EllerGenerator::find(int col) {
+  auto idx = static_cast<std::size_t>(col);
+  while (parent_[idx] != static_cast<int>(idx)) {
+    parent_[idx] = parent_[static_cast<std::size_t>(parent_[idx])];
+    idx = static_cast<std::size_t>(parent_[idx]);
+  }
+  return static_cast<int>(idx);
+}
+
+void EllerGenerator::join_horizontally(bool join_all) {
+  for (int col = 0; col + 1 < num_cols_; ++col) {
+    const int left = find(col);
+    const int right = find(col + 1);
+    const bool join =
+        left != right &&
+        (join_all || rng_.chance(options_.merge_probability));
+    open_east_[static_cast<std::size_t>(col)] = join;
+    if (join) parent_[static_cast<std::size_t>(right)] = left;
+  }
+}
+
+// Every set carves south at least once, so nothing above gets cut off: the
+// last cell of a set that has not gone down yet always does.
+void EllerGenerator::carve_down() {
+  for (int col = 0; col < num_cols_; ++col) {
+    const auto root = static_cast<std::size_t>(find(col));
+    ++cells_left_[root];
+    carried_down_[root] = false;
+  }
+
+  for (int col = 0; col < num_cols_; ++col) {
+    const int root = find(col);
+    const auto root_idx = static_cast<std::size_t>(root);
+    const auto idx = static_cast<std::size_t>(col);
+    --cells_left_[root_idx];
+    const bool last_chance =
+        cells_left_[root_idx] == 0 && not carried_down_[root_idx];
+    const bool down = rng_.chance(options_.down_probability) || last_chance;
+    open_south_[idx] = down;
+    if (down) carried_down_[root_idx] = true;
+    labels_[idx] = down ? root : num_cols_ + col;
+  }
+}
+
+std::span<const WallMask> EllerGenerator::emit_row(bool last) {
+  for (std::size_t col = 0; col < row_.size(); ++col) {
+    WallMask mask = 0;
+    if (not open_north_[col]) mask |= WallBit(Direction::North);
+    if (not open_east_[col]) mask |= WallBit(Direction::East);
+    if (not open_south_[col]) mask |= WallBit(Direction::South);
+    if (col == 0 || not open_east_[col - 1]) mask |= WallBit(Direction::West);
+    row_[col] = mask;
+  }
+
+  open_north_ = open_south_;
+  if (last) {
+    for (int col = 0; col < num_cols_; ++col) {
+      labels_[static_cast<std::size_t>(col)] = num_cols_ + col;
+    }
+  }
+
+  ++rows_emitted_;
+  return row_;
+}
+
+outcome::result<void> GenerateMazeRows(int num_cols, std::int64_t num_rows,
+                                       const EllerOptions& options,
+                                       const RowSink& sink) {
+  if (num_rows <= 0) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  EllerGenerator generator =
+      OUTCOME_TRYX(EllerGenerator::Make(num_cols, options));
+  for (std::int64_t row = 0; row + 1 < num_rows; ++row) {
+    OUTCOME_TRYV(sink(generator.NextRow()));
+  }
+  return sink(generator.LastRow());
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <outcome.hpp>
+#include <span>
+#include <vector>
+
+#include "maze_walls.hpp"
+#include "random.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+struct EllerOptions {
+  // Chance of joining two horizontally adjacent cells of different sets.
+  double merge_probability = 0.5;
+  // Chance of a cell carving south, on top of the one carve per set that
+  // keeps the set connected to the rows below.
+  double down_probability = 0.3;
+  std::optional<std::uint64_t> seed;
+};
+
+// Row-streaming maze generation with Eller's algorithm. Only the row being
+// finished is kept: set membership, the passages coming down from the row
+// above and the output masks, all O(width). Any number of rows can be
+// produced, and the result is a perfect maze once LastRow() is called.
+//
+// Rows use the wall semantics of ToMazeData: one WallMask per cell, with the
+// outer boundary closed and the N/W walls mirroring the neighbours' S/E ones.
+class EllerGenerator {
+  EllerOptions options_;
+  util::Xoshiro256 rng_;
+  int num_cols_;
+  std::int64_t rows_emitted_ = 0;
+
+  // Set label of every cell of the current row. Labels below num_cols_ are
+  // column indices of set representatives carried over from the row above,
+  // num_cols_ + c is the fresh singleton set of column c.
+  std::vector<int> labels_;
+  // Union-find over the columns of the current row.
+  std::vector<int> parent_;
+  // Scratch: representative column per label, then cells left to visit and
+  // whether the set already went down, per representative column.
+  std::vector<int> label_root_;
+  std::vector<int> cells_left_;
+  std::vector<bool> carried_down_;
+  std::vector<bool> open_north_;
+  std::vector<bool> open_east_;
+  std::vector<bool> open_south_;
+  std::vector<WallMask> row_;
+
+  EllerGenerator(const EllerOptions& options, std::uint64_t seed,
+                 int num_cols);
+
+ public:
+  static outcome::result<EllerGenerator> Make(int num_cols,
+                                              const EllerOptions& options = {});
+
+  int num_cols() const { return num_cols_; }
+  std::int64_t rows_emitted() const { return rows_emitted_; }
+
+  // Finishes the next row, leaving room for more rows below it. The span is
+  // valid until the next call.
+  std::span<const WallMask> NextRow();
+
+  // Finishes the bottom row, joining every set that is still separate.
+  // Further calls start a new, unrelated maze below.
+  std::span<const WallMask> LastRow();
+
+ private:
+  void start_row();
+  int find(int col);
+  void join_horizontally(bool join_all);
+  void carve_down();
+  std::span<const WallMask> emit_row(bool last);
+};
+
+using RowSink = std::function<outcome::result<void>(std::span<const WallMask>)>;
+
+// Streams a num_rows x num_cols maze to `sink` one row at a time, top to
+// bottom. Stops at the first error returned by the sink.
+outcome::result<void> GenerateMazeRows(int num_cols, std::int64_t num_rows,
+                                       const EllerOptions& options,
+                                       const RowSink& sink);
+
+}  // namespace maze_walker
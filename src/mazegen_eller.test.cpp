@@ -0,0 +1,125 @@
+#include "mazegen_eller.hpp"
+
+#include <catch2/catch.hpp>
+#include <limits>
+#include <system_error>
+
+#include "maze_tree_check.test.hpp"
+
+namespace maze_walker {
+namespace {
+
+SquareRectangularMazeData collect_rows(int num_cols, int num_rows,
+                                       const EllerOptions& options) {
+  SquareRectangularMazeData data;
+  data.set_num_cols(num_cols);
+  data.set_num_rows(num_rows);
+  const auto sink = [&data](std::span<const WallMask> row)
+      -> outcome::result<void> {
+    for (const WallMask mask : row) {
+      auto* cell = data.add_walls();
+      cell->set_n(mask & WallBit(Direction::North));
+      cell->set_e(mask & WallBit(Direction::East));
+      cell->set_s(mask & WallBit(Direction::South));
+      cell->set_w(mask & WallBit(Direction::West));
+    }
+    return outcome::success();
+  };
+  REQUIRE(GenerateMazeRows(num_cols, num_rows, options, sink));
+  return data;
+}
+
+}  // namespace
+
+TEST_CASE("Eller rows form one perfect maze", "[maze_eller]") {
+  const auto [cols, rows] = GENERATE(table<int, int>(
+      {{1, 1}, {1, 9}, {9, 1}, {2, 2}, {37, 23}, {64, 64}}));
+  EllerOptions options;
+  options.merge_probability = GENERATE(0.0, 0.5, 1.0);
+  options.down_probability = GENERATE(0.0, 0.3, 1.0);
+
+  const SquareRectangularMazeData data = collect_rows(cols, rows, options);
+  REQUIRE(data.walls_size() == cols * rows);
+
+  const TreeCheck check = check_tree(data);
+  REQUIRE(check.symmetric);
+  REQUIRE(check.passages == cols * rows - 1);
+  REQUIRE(check.reachable == cols * rows);
+
+  for (int idx = 0; idx < cols * rows; ++idx) {
+    const auto& cell = data.walls(idx);
+    if (idx < cols) REQUIRE(cell.n());
+    if (idx >= cols * (rows - 1)) REQUIRE(cell.s());
+    if (idx % cols == 0) REQUIRE(cell.w());
+    if (idx % cols == cols - 1) REQUIRE(cell.e());
+  }
+}
+
+TEST_CASE("Eller generator with the same seed repeats", "[maze_eller]") {
+  EllerOptions options;
+  options.seed = 2024;
+  const auto first = collect_rows(50, 40, options);
+  const auto second = collect_rows(50, 40, options);
+  REQUIRE(first.SerializeAsString() == second.SerializeAsString());
+
+  options.seed = 2025;
+  const auto other = collect_rows(50, 40, options);
+  REQUIRE(first.SerializeAsString() != other.SerializeAsString());
+}
+
+TEST_CASE("Eller generator starts over after the last row", "[maze_eller]") {
+  EllerGenerator generator = EllerGenerator::Make(8).value();
+  for (int maze = 0; maze < 3; ++maze) {
+    for (int row = 0; row < 5; ++row) {
+      for (const WallMask mask : generator.NextRow()) {
+        if (row == 0) REQUIRE(mask & WallBit(Direction::North));
+      }
+    }
+    for (const WallMask mask : generator.LastRow()) {
+      REQUIRE(mask & WallBit(Direction::South));
+    }
+  }
+  REQUIRE(generator.rows_emitted() == 18);
+}
+
+TEST_CASE("Eller generator rejects invalid arguments", "[maze_eller]") {
+  REQUIRE_FALSE(EllerGenerator::Make(0));
+
+  EllerOptions options;
+  options.merge_probability = 1.5;
+  REQUIRE_FALSE(EllerGenerator::Make(4, options));
+  options.merge_probability = 0.5;
+  options.down_probability = -0.1;
+  REQUIRE_FALSE(EllerGenerator::Make(4, options));
+
+  const auto sink = [](std::span<const WallMask>) -> outcome::result<void> {
+    return outcome::success();
+  };
+  REQUIRE_FALSE(GenerateMazeRows(4, 0, {}, sink));
+}
+
+TEST_CASE("Eller rows whose set labels overflow int are rejected",
+          "[maze_eller]") {
+  // Checked before anything is allocated.
+  constexpr int kMaxCols = std::numeric_limits<int>::max() / 2;
+  REQUIRE(EllerGenerator::Make(kMaxCols + 1).error() ==
+          std::errc::value_too_large);
+  REQUIRE(EllerGenerator::Make(std::numeric_limits<int>::max()).error() ==
+          std::errc::value_too_large);
+}
+
+TEST_CASE("Eller streaming stops at the first sink error", "[maze_eller]") {
+  int rows_seen = 0;
+  const auto sink = [&rows_seen](std::span<const WallMask>)
+      -> outcome::result<void> {
+    if (++rows_seen == 3) {
+      return outcome::failure(std::errc::no_space_on_device);
+    }
+    return outcome::success();
+  };
+  const auto streamed = GenerateMazeRows(16, 100, {}, sink);
+  REQUIRE_FALSE(streamed);
+  REQUIRE(streamed.error() == std::errc::no_space_on_device);
+  REQUIRE(rows_seen == 3);
+}
+}  // namespace maze_walker
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "grid.hpp"
+#include "maze_walls.hpp"
+#include "random.hpp"
+
+namespace maze_walker {
+
+// A maze whose size is part of its type: the NESW walls of every cell, the
+// outer boundary included, in a fixed-size grid.
+template <int Rows, int Cols>
+using FixedMaze = util::Grid<WallMask, Rows, Cols>;
+
+// The recursive backtracker over fixed-size storage, so that a seeded maze
+// can be generated in a constant expression and baked into the binary:
+//
+//   constexpr auto kLevel = GenerateFixedMaze<8, 8>(42);
+//
+// Random numbers are drawn in the same order as GrowingTreeGenerator with
+// SelectionStrategy::Newest, so the maze is the one GenerateMaze returns for
+// that strategy and seed. Meant for puzzle-sized mazes: compilers cap the
+// work of one constant evaluation.
+template <int Rows, int Cols>
+constexpr FixedMaze<Rows, Cols> GenerateFixedMaze(std::uint64_t seed) {
+  using Maze = FixedMaze<Rows, Cols>;
+  constexpr auto kCells = Maze::size();
+  constexpr auto kCols = static_cast<std::size_t>(Cols);
+
+  util::Xoshiro256 rng{seed};
+  Maze maze{static_cast<WallMask>(0xfu)};
+  std::array<bool, kCells> visited{};
+  // Every cell is pushed at most once.
+  std::array<std::size_t, kCells> active{};
+  std::size_t num_active = 0;
+
+  const auto row = rng.below(static_cast<std::uint32_t>(Rows));
+  const auto col = rng.below(static_cast<std::uint32_t>(Cols));
+  const std::size_t start = row * kCols + col;
+  visited[start] = true;
+  active[num_active++] = start;
+
+  while (num_active > 0) {
+    const std::size_t cell = active[num_active - 1];
+    const auto cell_row = static_cast<int>(cell / kCols);
+    const auto cell_col = static_cast<int>(cell % kCols);
+
+    unsigned candidates = 0;
+    if (cell_row > 0 && not visited[cell - kCols]) {
+      candidates |= WallBit(Direction::North);
+    }
+    if (cell_col < Cols - 1 && not visited[cell + 1]) {
+      candidates |= WallBit(Direction::East);
+    }
+    if (cell_row < Rows - 1 && not visited[cell + kCols]) {
+      candidates |= WallBit(Direction::South);
+    }
+    if (cell_col > 0 && not visited[cell - 1]) {
+      candidates |= WallBit(Direction::West);
+    }
+    if (candidates == 0) {
+      --num_active;
+      continue;
+    }
+
+    auto skip =
+        rng.below(static_cast<std::uint32_t>(std::popcount(candidates)));
+    for (; skip > 0; --skip) candidates &= candidates - 1;
+    const auto dir = static_cast<Direction>(std::countr_zero(candidates));
+
+    std::size_t next = cell;
+    Direction back = dir;
+    switch (dir) {
+      case Direction::North:
+        next -= kCols;
+        back = Direction::South;
+        break;
+      case Direction::East:
+        next += 1;
+        back = Direction::West;
+        break;
+      case Direction::South:
+        next += kCols;
+        back = Direction::North;
+        break;
+      case Direction::West:
+        next -= 1;
+        back = Direction::East;
+        break;
+    }
+    maze[cell] &= static_cast<WallMask>(~WallBit(dir));
+    maze[next] &= static_cast<WallMask>(~WallBit(back));
+    visited[next] = true;
+    active[num_active++] = next;
+  }
+  return maze;
+}
+
+// The fixed maze as planes, for everything that works on WallPlanes.
+template <int Rows, int Cols>
+outcome::result<WallPlanes> ToWallPlanes(const FixedMaze<Rows, Cols>& maze) {
+  WallPlanes walls = OUTCOME_TRYX(WallPlanes::Make(Rows, Cols));
+  for (int row = 0; row < Rows; ++row) {
+    for (int col = 0; col < Cols; ++col) {
+      const WallMask cell = maze.at(OUTCOME_TRYX(maze.MakeLocation(row, col)));
+      const auto idx = walls.wall_down.bit_index(row, col);
+      if (row + 1 < Rows && not(cell & WallBit(Direction::South))) {
+        walls.wall_down.reset_bit(idx);
+      }
+      if (col + 1 < Cols && not(cell & WallBit(Direction::East))) {
+        walls.wall_right.reset_bit(idx);
+      }
+    }
+  }
+  return walls;
+}
+
+}  // namespace maze_walker
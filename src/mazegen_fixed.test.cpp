@@ -0,0 +1,51 @@
+#include "mazegen_fixed.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "maze_validate.hpp"
+#include "mazegen_growing_tree.hpp"
+
+namespace maze_walker {
+namespace {
+
+template <int Rows, int Cols>
+void require_same_as_growing_tree(std::uint64_t seed) {
+  const auto fixed = GenerateFixedMaze<Rows, Cols>(seed);
+
+  GrowingTreeOptions options;
+  options.strategy = SelectionStrategy::Newest;
+  options.seed = seed;
+  const WallPlanes runtime =
+      FromMazeData(GenerateMaze(Cols, Rows, options).value()).value();
+  for (int row = 0; row < Rows; ++row) {
+    for (int col = 0; col < Cols; ++col) {
+      REQUIRE(fixed.at(fixed.MakeLocation(row, col).value()) ==
+              CellWalls(runtime, row, col));
+    }
+  }
+
+  const WallPlanes planes = ToWallPlanes(fixed).value();
+  REQUIRE(ValidatePerfectMaze(planes));
+  REQUIRE(ToMazeData(planes).value().SerializeAsString() ==
+          ToMazeData(runtime).value().SerializeAsString());
+}
+
+}  // namespace
+
+TEST_CASE("Fixed mazes match the growing tree with the same seed",
+          "[mazegen_fixed]") {
+  const auto seed = GENERATE(0u, 1u, 42u, 2024u);
+  require_same_as_growing_tree<1, 1>(seed);
+  require_same_as_growing_tree<1, 9>(seed);
+  require_same_as_growing_tree<7, 1>(seed);
+  require_same_as_growing_tree<9, 13>(seed);
+  require_same_as_growing_tree<32, 32>(seed);
+}
+
+TEST_CASE("Fixed mazes can be baked in", "[mazegen_fixed]") {
+  static constexpr auto kLevel = GenerateFixedMaze<6, 10>(7);
+  REQUIRE(ValidatePerfectMaze(ToWallPlanes(kLevel).value()));
+  REQUIRE(kLevel == GenerateFixedMaze<6, 10>(7));
+}
+
+}  // namespace maze_walker
@@ -1,242 +1,253 @@
 #include "mazegen_growing_tree.hpp"
 
-#include <random>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <system_error>
 
-#include "grid.hpp"
+#include "profile.hpp"
 
 namespace maze_walker {
 namespace {
 
-enum class State {
-  New,
-  Active,
-  Inactive,
-};
+using Index = util::BitGrid::size_type;
 
-struct Cell {
-  State state;
-  bool wall_down;
-  bool wall_right;
+unsigned bit(Direction dir) { return 1u << static_cast<unsigned>(dir); }
 
-  Cell() : state{State::New}, wall_down{true}, wall_right{true} {}
-};
+}  // namespace
 
-using Loc = util::Grid<Cell>::Location;
+GrowingTreeGenerator::GrowingTreeGenerator(const GrowingTreeOptions& options,
+                                           std::uint64_t seed,
+                                           util::BitGrid visited,
+                                           WallPlanes walls)
+    : options_{options},
+      rng_{seed},
+      visited_{std::move(visited)},
+      walls_{std::move(walls)},
+      col_bits_{static_cast<int>(
+          std::bit_width(static_cast<unsigned>(num_cols() - 1)))} {
+  MAZE_PROFILE_COUNT("growing_tree.alloc_bytes",
+                     (visited_.words().size() +
+                      walls_.wall_down.words().size() +
+                      walls_.wall_right.words().size()) *
+                         sizeof(util::BitGrid::Word));
+  const auto row = rng_.below(static_cast<std::uint32_t>(num_rows()));
+  const auto col = rng_.below(static_cast<std::uint32_t>(num_cols()));
+  activate(Position{static_cast<int>(row), static_cast<int>(col)});
+}
+
+outcome::result<GrowingTreeGenerator> GrowingTreeGenerator::Make(
+    int num_cols, int num_rows, const GrowingTreeOptions& options) {
+  MAZE_PROFILE_SCOPE("growing_tree.make");
+  if (not(options.random_ratio >= 0.0 && options.random_ratio <= 1.0)) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+  // Active cells are stored as 32-bit keys, see position_of.
+  if (num_rows > 0 && num_cols > 0 &&
+      std::bit_width(static_cast<unsigned>(num_rows - 1)) +
+              std::bit_width(static_cast<unsigned>(num_cols - 1)) >
+          32) {
+    return outcome::failure(std::errc::value_too_large);
+  }
 
-bool has_north_wall(const util::Grid<Cell>& grid,
-                    const util::Grid<Cell>::Location& loc) {
-  if (loc.row() == 0) return true;
-  const auto one_up = grid.MakeLocation(loc.row() - 1, loc.col()).value();
-  return grid.at(one_up).wall_down;
+  util::BitGrid visited =
+      OUTCOME_TRYX(util::BitGrid::Make(num_rows, num_cols, false));
+  WallPlanes walls = OUTCOME_TRYX(WallPlanes::Make(num_rows, num_cols));
+  const std::uint64_t seed =
+      options.seed ? *options.seed : util::RandomDeviceSeed();
+  return GrowingTreeGenerator{options, seed, std::move(visited),
+                              std::move(walls)};
 }
 
-bool has_east_wall(const util::Grid<Cell>& grid,
-                   const util::Grid<Cell>::Location& loc) {
-  return grid.at(loc).wall_right;
-}
+std::optional<CarveEvent> GrowingTreeGenerator::Next() {
+  while (not finished()) {
+    if (const auto event = step()) return event;
+  }
+  publish_counts();
+  return std::nullopt;
+}
+
+std::optional<CarveEvent> GrowingTreeGenerator::step() {
+  assert(not finished());
+  if constexpr (util::kProfilingEnabled) ++steps_;
+  const std::size_t slot = select_slot();
+  const Position current = position_of(active_at(slot));
+  const unsigned candidates = new_neighbours(current);
+  if (candidates == 0) {
+    retire(slot);
+    return std::nullopt;
+  }
 
-bool has_south_wall(const util::Grid<Cell>& grid,
-                    const util::Grid<Cell>::Location& loc) {
-  return grid.at(loc).wall_down;
+  return carve(current, random_direction(candidates));
 }
 
-bool has_west_wall(const util::Grid<Cell>& grid,
-                   const util::Grid<Cell>::Location& loc) {
-  if (loc.col() == 0) return true;
-  const auto one_left = grid.MakeLocation(loc.row(), loc.col() - 1).value();
-  return grid.at(one_left).wall_right;
+std::size_t GrowingTreeGenerator::select_slot() {
+  switch (options_.strategy) {
+    case SelectionStrategy::Newest:
+      return num_active_ - 1;
+    case SelectionStrategy::Oldest:
+      return 0;
+    case SelectionStrategy::Random:
+      return random_slot();
+    case SelectionStrategy::Mixed:
+      return rng_.chance(options_.random_ratio) ? random_slot()
+                                                : num_active_ - 1;
+  }
+  assert(false);
+  return num_active_ - 1;
 }
 
-bool is_directly_left_of(const Loc& x, const Loc& y) {
-  return x.row() == y.row() && x.col() - 1 == y.col();
+std::size_t GrowingTreeGenerator::random_slot() {
+  return rng_.below(static_cast<std::uint32_t>(num_active_));
 }
 
-bool is_directly_right_of(const Loc& x, const Loc& y) {
-  return x.row() == y.row() && x.col() + 1 == y.col();
+std::uint32_t& GrowingTreeGenerator::active_at(std::size_t slot) {
+  return active_[(active_head_ + slot) & (active_.size() - 1)];
 }
 
-bool is_directly_above(const Loc& x, const Loc& y) {
-  return x.row() - 1 == y.row() && x.col() == y.col();
+GrowingTreeGenerator::Position GrowingTreeGenerator::position_of(
+    std::uint32_t key) const {
+  // A shift and a mask rather than a division: this runs every step.
+  const std::uint32_t col_mask = (std::uint32_t{1} << col_bits_) - 1;
+  return Position{static_cast<int>(key >> col_bits_),
+                  static_cast<int>(key & col_mask)};
 }
 
-bool is_directly_below(const Loc& x, const Loc& y) {
-  return x.row() + 1 == y.row() && x.col() == y.col();
+// Picks one of the directions set in `candidates` uniformly at random.
+Direction GrowingTreeGenerator::random_direction(unsigned candidates) {
+  assert(candidates != 0);
+  auto skip = rng_.below(static_cast<std::uint32_t>(std::popcount(candidates)));
+  for (; skip > 0; --skip) candidates &= candidates - 1;
+  return static_cast<Direction>(std::countr_zero(candidates));
 }
 
-outcome::result<SquareRectangularMazeData> grid_to_maze(
-    const util::Grid<Cell>& grid) {
-  SquareRectangularMazeData maze;
-  maze.set_num_cols(grid.num_cols());
-  maze.set_num_rows(grid.num_rows());
-
-  for (int row = 0; row < grid.num_rows(); ++row) {
-    for (int col = 0; col < grid.num_cols(); ++col) {
-      const auto loc = OUTCOME_TRYX(grid.MakeLocation(row, col));
-
-      auto* cell = maze.add_walls();
-      cell->set_n(has_north_wall(grid, loc));
-      cell->set_e(has_east_wall(grid, loc));
-      cell->set_s(has_south_wall(grid, loc));
-      cell->set_w(has_west_wall(grid, loc));
-    }
+void GrowingTreeGenerator::retire(std::size_t slot) {
+  if constexpr (util::kProfilingEnabled) ++backtracks_;
+  const std::size_t newest = num_active_ - 1;
+  if (slot != newest && options_.strategy == SelectionStrategy::Random) {
+    active_at(slot) = active_at(newest);
+  } else if (slot != newest) {
+    active_at(slot) = active_at(0);
+    active_head_ = (active_head_ + 1) & (active_.size() - 1);
   }
-
-  return maze;
-}
-
-int random_int_from_range(int a, int b) {
-  using UID = std::uniform_int_distribution<>;
-  static std::default_random_engine gen{std::random_device{}()};
-  return UID{a, b}(gen);
-}
-
-Loc random_location(const util::Grid<Cell>& grid) {
-  const int row_idx = random_int_from_range(0, grid.num_rows() - 1);
-  const int col_idx = random_int_from_range(0, grid.num_cols() - 1);
-  return grid.MakeLocation(row_idx, col_idx).value();
-}
-
-bool not_finished([[maybe_unused]] const util::Grid<Cell>& grid,
-                  const std::vector<Loc>& active_set) {
-  return not active_set.empty();
-}
-
-std::vector<Loc>::iterator next_loc(std::vector<Loc>& active_set) {
-  return active_set.end() - 1;
+  --num_active_;
 }
 
-template <typename Pred>
-std::vector<Loc> neighbours_for(const util::Grid<Cell>& grid, const Loc& loc,
-                                Pred pred) {
-  std::vector<Loc> neighbours;
-  neighbours.reserve(4);
+unsigned GrowingTreeGenerator::new_neighbours(const Position& pos) const {
+  const Index idx = visited_.bit_index(pos.row, pos.col);
+  const Index stride = visited_.row_stride();
+  const auto is_new = [this](Index bit) { return not visited_.test_bit(bit); };
 
-  if (loc.row() > 0) {
-    auto n_loc = grid.MakeLocation(loc.row() - 1, loc.col()).value();
-    if (pred(grid.at(n_loc))) neighbours.push_back(n_loc);
+  unsigned mask = 0;
+  if (pos.row > 0 && is_new(idx - stride)) mask |= bit(Direction::North);
+  if (pos.col < num_cols() - 1 && is_new(idx + 1)) {
+    mask |= bit(Direction::East);
   }
-
-  if (loc.col() > 0) {
-    auto n_loc = grid.MakeLocation(loc.row(), loc.col() - 1).value();
-    if (pred(grid.at(n_loc))) neighbours.push_back(n_loc);
-  }
-
-  if (loc.row() < grid.num_rows() - 1) {
-    auto n_loc = grid.MakeLocation(loc.row() + 1, loc.col()).value();
-    if (pred(grid.at(n_loc))) neighbours.push_back(n_loc);
+  if (pos.row < num_rows() - 1 && is_new(idx + stride)) {
+    mask |= bit(Direction::South);
   }
-
-  if (loc.col() < grid.num_cols() - 1) {
-    auto n_loc = grid.MakeLocation(loc.row(), loc.col() + 1).value();
-    if (pred(grid.at(n_loc))) neighbours.push_back(n_loc);
+  if (pos.col > 0 && is_new(idx - 1)) mask |= bit(Direction::West);
+  return mask;
+}
+
+CarveEvent GrowingTreeGenerator::carve(const Position& from, Direction dir) {
+  Position to = from;
+  switch (dir) {
+    case Direction::North:
+      to.row -= 1;
+      break;
+    case Direction::East:
+      to.col += 1;
+      break;
+    case Direction::South:
+      to.row += 1;
+      break;
+    case Direction::West:
+      to.col -= 1;
+      break;
   }
 
-  return neighbours;
-}
-
-bool is_new(const Cell& cell) { return cell.state == State::New; }
-// bool is_not_new(const Cell& cell) { return cell.state != State::New; }
-
-bool has_no_new_neighbours(const util::Grid<Cell>& grid, const Loc& loc) {
-  const auto new_neighbours = neighbours_for(grid, loc, is_new);
-  return new_neighbours.empty();
-}
-
-void remove_location(std::vector<Loc>& active_set,
-                     std::vector<Loc>::iterator elem) {
-  active_set.erase(elem);
+  const CarveEvent event{from.row, from.col, dir};
+  walls_.Carve(event);
+  activate(to);
+  return event;
 }
 
-void merge_random_neighbour(util::Grid<Cell>& grid,
-                            std::vector<Loc>& active_set, const Loc loc) {
-  std::vector<Loc> new_neighbours = neighbours_for(grid, loc, is_new);
-  auto idx = static_cast<std::size_t>(
-      random_int_from_range(0, static_cast<int>(new_neighbours.size()) - 1));
-  const Loc& random_neighbour_loc = new_neighbours[idx];
-  active_set.push_back(random_neighbour_loc);
-  grid.at(random_neighbour_loc).state = State::Active;
-
-  if (is_directly_left_of(loc, random_neighbour_loc)) {
-    assert(grid.at(random_neighbour_loc).wall_right == true);
-    grid.at(random_neighbour_loc).wall_right = false;
-    return;
-  }
-
-  if (is_directly_above(loc, random_neighbour_loc)) {
-    assert(grid.at(random_neighbour_loc).wall_down == true);
-    grid.at(random_neighbour_loc).wall_down = false;
-    return;
-  }
-
-  if (is_directly_below(loc, random_neighbour_loc)) {
-    assert(grid.at(loc).wall_down == true);
-    grid.at(loc).wall_down = false;
-    return;
+void GrowingTreeGenerator::activate(const Position& pos) {
+  visited_.set_bit(visited_.bit_index(pos.row, pos.col));
+  if (num_active_ == active_.size()) {
+    // Unrolled into a buffer twice the size, oldest cell first.
+    std::vector<std::uint32_t> grown(
+        std::max<std::size_t>(16, 2 * num_active_));
+    for (std::size_t slot = 0; slot < num_active_; ++slot) {
+      grown[slot] = active_at(slot);
+    }
+    MAZE_PROFILE_COUNT("growing_tree.alloc_bytes",
+                       grown.size() * sizeof(std::uint32_t));
+    active_ = std::move(grown);
+    active_head_ = 0;
   }
-
-  if (is_directly_right_of(loc, random_neighbour_loc)) {
-    assert(grid.at(loc).wall_right == true);
-    grid.at(loc).wall_right = false;
-    return;
+  ++num_active_;
+  active_at(num_active_ - 1) = static_cast<std::uint32_t>(pos.row)
+                                  << col_bits_ |
+                              static_cast<std::uint32_t>(pos.col);
+  if constexpr (util::kProfilingEnabled) {
+    peak_active_ = std::max(peak_active_, num_active_);
   }
-
-  assert(false);
-  return;
 }
 
-}  // namespace
-
-outcome::result<SquareRectangularMazeData> GenerateMaze(int num_cols,
-                                                        int num_rows) {
-  util::Grid<Cell> grid =
-      OUTCOME_TRYX(util::Grid<Cell>::Make(num_cols, num_rows, Cell{}));
+void GrowingTreeGenerator::publish_counts() {
+  if (steps_ == 0) return;
+  MAZE_PROFILE_COUNT("growing_tree.steps", steps_);
+  MAZE_PROFILE_COUNT("growing_tree.backtracks", backtracks_);
+  MAZE_PROFILE_PEAK("growing_tree.active_peak", peak_active_);
+  steps_ = 0;
+  backtracks_ = 0;
+  peak_active_ = 0;
+}
 
-  std::vector<Loc> active_set;
-  active_set.push_back(random_location(grid));
-  grid.at(active_set.back()).state = State::Active;
+outcome::result<SquareRectangularMazeData> GenerateMaze(
+    int num_cols, int num_rows, const GrowingTreeOptions& options) {
+  SquareRectangularMazeData maze;
+  OUTCOME_TRYV(GenerateMaze(num_cols, num_rows, options, maze));
+  return maze;
+}
 
-  while (not_finished(grid, active_set)) {
-    auto next = next_loc(active_set);
-    assert(next != active_set.end());
+outcome::result<void> GenerateMaze(int num_cols, int num_rows,
+                                   const GrowingTreeOptions& options,
+                                   SquareRectangularMazeData& out,
+                                   WallEncoding encoding) {
+  // ToMazeData takes at most INT_MAX cells; checked before carving rather
+  // than after.
+  if (num_rows > 0 && num_cols > 0 &&
+      static_cast<std::int64_t>(num_rows) * num_cols > INT_MAX) {
+    return outcome::failure(std::errc::value_too_large);
+  }
 
-    if (has_no_new_neighbours(grid, *next)) {
-      remove_location(active_set, next);
-      continue;
+  GrowingTreeGenerator generator =
+      OUTCOME_TRYX(GrowingTreeGenerator::Make(num_cols, num_rows, options));
+  {
+    MAZE_PROFILE_SCOPE("growing_tree.carve");
+    while (generator.Next()) {
     }
-
-    merge_random_neighbour(grid, active_set, *next);
   }
 
-  return grid_to_maze(grid);
+  return ToMazeData(generator.walls(), out, encoding);
 }
 
-outcome::result<std::vector<SquareRectangularMazeData>> GenerateMazeWithSteps(int num_cols,
-                                                             int num_rows) {
-  util::Grid<Cell> grid =
-      OUTCOME_TRYX(util::Grid<Cell>::Make(num_cols, num_rows, Cell{}));
-
-  std::vector<Loc> active_set;
-  active_set.push_back(random_location(grid));
-  grid.at(active_set.back()).state = State::Active;
-
-  std::vector<SquareRectangularMazeData> sequence;
-  sequence.reserve(static_cast<size_t>(grid.num_cols() * grid.num_rows()));
-
-  sequence.push_back(OUTCOME_TRYX(grid_to_maze(grid)));
-
-  while (not_finished(grid, active_set)) {
-    auto next = next_loc(active_set);
-    assert(next != active_set.end());
-
-    if (has_no_new_neighbours(grid, *next)) {
-      remove_location(active_set, next);
-      continue;
-    }
+outcome::result<MazeStepLog> GenerateMazeWithSteps(
+    int num_cols, int num_rows, const GrowingTreeOptions& options) {
+  GrowingTreeGenerator generator =
+      OUTCOME_TRYX(GrowingTreeGenerator::Make(num_cols, num_rows, options));
+  MazeStepLog log = OUTCOME_TRYX(
+      MazeStepLog::Make(generator.num_rows(), generator.num_cols()));
 
-    merge_random_neighbour(grid, active_set, *next);
-    sequence.push_back(OUTCOME_TRYX(grid_to_maze(grid)));
+  while (const auto event = generator.Next()) {
+    OUTCOME_TRYV(log.Append(*event));
   }
 
-  return sequence;
+  return log;
 }
 }  // namespace maze_walker
@@ -1,17 +1,141 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <outcome.hpp>
+#include <vector>
 
+#include "bit_grid.hpp"
+#include "maze_step_log.hpp"
+#include "maze_walls.hpp"
+#include "random.hpp"
 #include "square_rectangular_maze.pb.h"
 
 namespace outcome = OUTCOME_V2_NAMESPACE;
 
 namespace maze_walker {
 
-outcome::result<SquareRectangularMazeData> GenerateMaze(int num_cols,
-                                                        int num_rows);
+// How the growing tree picks the active cell to carve from next. Newest is the
+// recursive backtracker (long winding passages, few dead ends), Random is the
+// simplified Prim's algorithm (short branches, many dead ends), Oldest grows
+// long straight runs from the start, and Mixed picks the newest cell but a
+// random one with probability `random_ratio`.
+enum class SelectionStrategy {
+  Newest,
+  Oldest,
+  Random,
+  Mixed,
+};
 
-outcome::result<std::vector<SquareRectangularMazeData>> GenerateMazeWithSteps(
-    int num_cols, int num_rows);
+// Generators are independent of each other, so any number can run
+// concurrently. The same seed and options always produce the same maze; with
+// no seed one is taken from std::random_device.
+struct GrowingTreeOptions {
+  SelectionStrategy strategy = SelectionStrategy::Newest;
+  double random_ratio = 0.5;
+  std::optional<std::uint64_t> seed;
+};
+
+// Resumable growing-tree generation. The loop over the active set is kept as
+// explicit state, so a maze can be carved one wall at a time: spread over
+// frames, or streamed out while generation is still running.
+//
+// The start cell is drawn inside the grid, after that all neighbour lookups are
+// plain bit-index arithmetic.
+//
+// The active cells are kept as 32-bit keys, row << col_bits_ | col, in a
+// ring buffer, oldest first, that doubles when the live set outgrows it, so
+// memory follows the peak number of active cells rather than the maze size.
+// Picking is O(1) for every strategy and so is retiring: the newest cell is
+// popped, the oldest one is dropped from the front, and any other cell is
+// overwritten by the newest one (Random) or, for Mixed, which has to keep
+// the newest cell at the back, by the oldest one.
+class GrowingTreeGenerator {
+  struct Position {
+    int row;
+    int col;
+  };
+
+  GrowingTreeOptions options_;
+  util::Xoshiro256 rng_;
+  util::BitGrid visited_;
+  WallPlanes walls_;
+  std::vector<std::uint32_t> active_;  // capacity is a power of two
+  std::size_t active_head_ = 0;        // slot of the oldest active cell
+  std::size_t num_active_ = 0;
+  int col_bits_;  // bits of a cell key that hold the column
+  // Steps, retirements and the largest active set not yet added to the
+  // profile counters. Kept here and published in bulk, see publish_counts.
+  std::uint64_t steps_ = 0;
+  std::uint64_t backtracks_ = 0;
+  std::size_t peak_active_ = 0;
+
+  GrowingTreeGenerator(const GrowingTreeOptions& options, std::uint64_t seed,
+                       util::BitGrid visited, WallPlanes walls);
+
+ public:
+  static outcome::result<GrowingTreeGenerator> Make(
+      int num_cols, int num_rows, const GrowingTreeOptions& options = {});
+
+  int num_rows() const { return walls_.num_rows(); }
+  int num_cols() const { return walls_.num_cols(); }
+
+  bool finished() const { return num_active_ == 0; }
+
+  // Runs the loop until the next wall is carved. Returns nothing once every
+  // cell has been reached.
+  std::optional<CarveEvent> Next();
+
+  // Carves up to `max_carves` walls, passing each to `sink`. Returns the
+  // number carved, which is less than `max_carves` only when finished.
+  template <typename Sink>
+  std::size_t Advance(std::size_t max_carves, Sink&& sink) {
+    std::size_t carved = 0;
+    for (; carved < max_carves; ++carved) {
+      const std::optional<CarveEvent> event = Next();
+      if (not event) break;
+      sink(*event);
+    }
+    publish_counts();
+    return carved;
+  }
+
+  // Walls carved so far.
+  const WallPlanes& walls() const { return walls_; }
+
+ private:
+  // One iteration of the loop: carves from the selected active cell, or
+  // retires it if it has no new neighbours left.
+  std::optional<CarveEvent> step();
+  // Active cells are addressed by age: 0 is the oldest, num_active_ - 1 the
+  // newest.
+  std::size_t select_slot();
+  std::size_t random_slot();
+  std::uint32_t& active_at(std::size_t slot);
+  Position position_of(std::uint32_t key) const;
+  Direction random_direction(unsigned candidates);
+  void retire(std::size_t slot);
+  unsigned new_neighbours(const Position& pos) const;
+  CarveEvent carve(const Position& from, Direction dir);
+  void activate(const Position& pos);
+  // Adds steps_ and backtracks_ to the profile counters, offers peak_active_
+  // to the active-set peak, and zeroes all three. Runs once Next() finds the
+  // maze finished and at the end of Advance, rather than every step: the
+  // counters are shared by every thread.
+  void publish_counts();
+};
+
+outcome::result<SquareRectangularMazeData> GenerateMaze(
+    int num_cols, int num_rows, const GrowingTreeOptions& options = {});
+
+// Generates into `out`, reusing what it holds, see ToMazeData.
+outcome::result<void> GenerateMaze(
+    int num_cols, int num_rows, const GrowingTreeOptions& options,
+    SquareRectangularMazeData& out,
+    WallEncoding encoding = WallEncoding::Repeated);
+
+outcome::result<MazeStepLog> GenerateMazeWithSteps(
+    int num_cols, int num_rows, const GrowingTreeOptions& options = {});
 
 }  // namespace maze_walker
@@ -1,13 +1,175 @@
 #include "mazegen_growing_tree.hpp"
 
+#include <algorithm>
 #include <catch2/catch.hpp>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "maze_tree_check.test.hpp"
+#include "profile.hpp"
 
 namespace maze_walker {
 TEST_CASE("Generate small maze", "[maze]") {
   SquareRectangularMazeData data = GenerateMaze(3, 3).value();
-  std::cout << data.DebugString();
   REQUIRE(data.num_cols() == 3);
   REQUIRE(data.num_rows() == 3);
+}
+
+TEST_CASE("Generated maze has the requested shape", "[maze]") {
+  const SquareRectangularMazeData data = GenerateMaze(5, 3).value();
+  REQUIRE(data.num_cols() == 5);
+  REQUIRE(data.num_rows() == 3);
+  REQUIRE(data.walls_size() == 5 * 3);
+}
+
+TEST_CASE("Generated maze is perfect", "[maze]") {
+  const SquareRectangularMazeData data = GenerateMaze(17, 31).value();
+  const int cells = data.num_cols() * data.num_rows();
+  REQUIRE(data.walls_size() == cells);
+
+  const TreeCheck check = check_tree(data);
+  REQUIRE(check.symmetric);
+  REQUIRE(check.passages == cells - 1);
+  REQUIRE(check.reachable == cells);
+}
+
+TEST_CASE("Every selection strategy generates a perfect maze", "[maze]") {
+  const auto strategy =
+      GENERATE(SelectionStrategy::Newest, SelectionStrategy::Oldest,
+               SelectionStrategy::Random, SelectionStrategy::Mixed);
+  GrowingTreeOptions options;
+  options.strategy = strategy;
+  options.random_ratio = 0.25;
+
+  const SquareRectangularMazeData data = GenerateMaze(23, 19, options).value();
+  const int cells = data.num_cols() * data.num_rows();
+  const TreeCheck check = check_tree(data);
+  REQUIRE(check.symmetric);
+  REQUIRE(check.passages == cells - 1);
+  REQUIRE(check.reachable == cells);
+}
+
+TEST_CASE("Seeded generation is reproducible", "[maze]") {
+  GrowingTreeOptions options;
+  options.strategy = SelectionStrategy::Mixed;
+  options.seed = 1234;
+  const auto first = GenerateMaze(12, 9, options).value();
+  const auto second = GenerateMaze(12, 9, options).value();
+  REQUIRE(first.SerializeAsString() == second.SerializeAsString());
+
+  options.seed = 1235;
+  const auto other = GenerateMaze(12, 9, options).value();
+  REQUIRE(first.SerializeAsString() != other.SerializeAsString());
+}
+
+TEST_CASE("Batches from adjacent base seeds share no mazes", "[maze]") {
+  // Maze i of a mazegen_cli batch is seeded with DeriveSeed(--seed, i).
+  std::set<std::string> mazes;
+  for (const std::uint64_t base : {1u, 2u}) {
+    for (std::uint64_t index = 0; index < 32; ++index) {
+      GrowingTreeOptions options;
+      options.seed = util::DeriveSeed(base, index);
+      REQUIRE(mazes.insert(GenerateMaze(8, 8, options).value()
+                               .SerializeAsString())
+                  .second);
+    }
+  }
+}
+
+TEST_CASE("Invalid mixing ratio is rejected", "[maze]") {
+  GrowingTreeOptions options;
+  options.strategy = SelectionStrategy::Mixed;
+  options.random_ratio = 1.5;
+  REQUIRE_FALSE(GrowingTreeGenerator::Make(4, 4, options));
+}
+
+TEST_CASE("Sizes whose cells do not fit 32-bit keys are rejected", "[maze]") {
+  // Checked before anything is allocated.
+  REQUIRE(GrowingTreeGenerator::Make(1 << 16, 1 << 17).error() ==
+          std::errc::value_too_large);
+  REQUIRE(GrowingTreeGenerator::Make(5, 1 << 30).error() ==
+          std::errc::value_too_large);
+}
+
+TEST_CASE("Mazes too large for a message are rejected before carving",
+          "[maze]") {
+  // 2^31 cells: valid 32-bit keys, but one more cell than ToMazeData takes.
+  REQUIRE(GenerateMaze(1 << 16, 1 << 15).error() ==
+          std::errc::value_too_large);
+  SquareRectangularMazeData out;
+  REQUIRE(GenerateMaze(1 << 15, 1 << 16, {}, out, WallEncoding::Packed)
+              .error() == std::errc::value_too_large);
+}
+
+TEST_CASE("Generation steps carve one wall each", "[maze]") {
+  const MazeStepLog steps = GenerateMazeWithSteps(4, 5).value();
+  REQUIRE(steps.num_steps() == 4 * 5);
+  REQUIRE(check_tree(steps.Materialize(0).value()).passages == 0);
+  REQUIRE(check_tree(steps.Materialize(7).value()).passages == 7);
+
+  const TreeCheck last = check_tree(steps.Materialize(4 * 5 - 1).value());
+  REQUIRE(last.passages == 4 * 5 - 1);
+  REQUIRE(last.reachable == 4 * 5);
+
+  WallPlanes planes = WallPlanes::Make(1, 1).value();
+  SquareRectangularMazeData scratch;
+  for (const std::size_t step : {std::size_t{19}, std::size_t{3}}) {
+    REQUIRE(steps.Materialize(step, planes, scratch));
+    REQUIRE(scratch.SerializeAsString() ==
+            steps.Materialize(step).value().SerializeAsString());
+  }
+}
+
+TEST_CASE("Generator can be advanced incrementally", "[maze]") {
+  GrowingTreeGenerator generator = GrowingTreeGenerator::Make(6, 5).value();
+  const int cells = generator.num_rows() * generator.num_cols();
+
+  std::vector<CarveEvent> events;
+  const auto collect = [&](const CarveEvent& event) { events.push_back(event); };
+  REQUIRE(generator.Advance(10, collect) == 10);
+  REQUIRE_FALSE(generator.finished());
+  REQUIRE(check_tree(ToMazeData(generator.walls()).value()).passages == 10);
+
+  REQUIRE(generator.Advance(1000, collect) ==
+          static_cast<std::size_t>(cells - 1 - 10));
+  REQUIRE(events.size() == static_cast<std::size_t>(cells - 1));
+  REQUIRE_FALSE(generator.Next());
+  REQUIRE(generator.finished());
+
+  const TreeCheck check = check_tree(ToMazeData(generator.walls()).value());
+  REQUIRE(check.passages == cells - 1);
+  REQUIRE(check.reachable == cells);
+}
+
+TEST_CASE("Generator profile counts cover every step", "[maze][profile]") {
+  const auto counted = [](std::string_view name) -> std::uint64_t {
+    const auto entries = util::ProfileSnapshot();
+    const auto it = std::find_if(
+        entries.begin(), entries.end(),
+        [name](const util::ProfileEntry& entry) { return entry.name == name; });
+    return it == entries.end() ? 0 : it->value;
+  };
+
+  util::ResetProfile();
+  GrowingTreeGenerator generator = GrowingTreeGenerator::Make(7, 4).value();
+  const auto cells = static_cast<std::uint64_t>(generator.num_rows() *
+                                                generator.num_cols());
+  generator.Advance(5, [](const CarveEvent&) {});
+  while (generator.Next()) {
+  }
 
+  if constexpr (util::kProfilingEnabled) {
+    // Every cell is retired once and every other step carves.
+    REQUIRE(counted("growing_tree.backtracks") == cells);
+    REQUIRE(counted("growing_tree.steps") == 2 * cells - 1);
+    const std::uint64_t peak = counted("growing_tree.active_peak");
+    REQUIRE(peak >= 1);
+    REQUIRE(peak <= cells);
+  } else {
+    REQUIRE(counted("growing_tree.steps") == 0);
+  }
 }
-}  // namespace util
+}  // namespace maze_walker
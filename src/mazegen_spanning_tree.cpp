@@ -0,0 +1,167 @@
+#include "mazegen_spanning_tree.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+#include "bit_grid.hpp"
+#include "disjoint_sets.hpp"
+#include "random.hpp"
+
+namespace maze_walker {
+namespace {
+
+std::uint64_t seed_of(const SpanningTreeOptions& options) {
+  return options.seed ? *options.seed : util::RandomDeviceSeed();
+}
+
+// Directions that stay inside the grid, as a NESW bit mask.
+unsigned inner_directions(int row, int col, int num_rows, int num_cols) {
+  unsigned mask = 0;
+  if (row > 0) mask |= WallBit(Direction::North);
+  if (col < num_cols - 1) mask |= WallBit(Direction::East);
+  if (row < num_rows - 1) mask |= WallBit(Direction::South);
+  if (col > 0) mask |= WallBit(Direction::West);
+  return mask;
+}
+
+// Uniform pick among the set bits of `mask`.
+Direction random_direction(util::Xoshiro256& rng, unsigned mask) {
+  for (auto pick = rng.below(static_cast<std::uint32_t>(std::popcount(mask)));
+       pick > 0; --pick) {
+    mask &= mask - 1;
+  }
+  return static_cast<Direction>(std::countr_zero(mask));
+}
+
+void move(int& row, int& col, Direction dir) {
+  switch (dir) {
+    case Direction::North:
+      --row;
+      break;
+    case Direction::East:
+      ++col;
+      break;
+    case Direction::South:
+      ++row;
+      break;
+    case Direction::West:
+      --col;
+      break;
+  }
+}
+
+}  // namespace
+
+// An edge is a cell index shifted left by one, with the low bit set for the
+// wall to the south and clear for the wall to the east. The list is built
+// already shuffled, with the inside-out Fisher-Yates shuffle, so it is
+// written once and read once, front to back.
+outcome::result<WallPlanes> GenerateKruskalWalls(
+    int num_cols, int num_rows, const SpanningTreeOptions& options) {
+  // Checked before allocating: edges and the shuffle's bounded draws are
+  // 32-bit, which holds up to INT32_MAX cells, also the DisjointSets limit.
+  if (static_cast<std::int64_t>(num_rows) * num_cols > INT32_MAX) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+  WallPlanes walls = OUTCOME_TRYX(WallPlanes::Make(num_rows, num_cols));
+  const std::size_t num_cells =
+      static_cast<std::size_t>(num_rows) * static_cast<std::size_t>(num_cols);
+  util::DisjointSets cells = OUTCOME_TRYX(util::DisjointSets::Make(num_cells));
+  util::Xoshiro256 rng{seed_of(options)};
+
+  std::vector<std::uint32_t> edges(
+      2 * num_cells - static_cast<std::size_t>(num_rows) -
+      static_cast<std::size_t>(num_cols));
+  std::size_t count = 0;
+  const auto add = [&](std::uint32_t edge) {
+    const std::size_t slot = rng.below(static_cast<std::uint32_t>(count + 1));
+    edges[count++] = edges[slot];
+    edges[slot] = edge;
+  };
+  std::uint32_t idx = 0;
+  for (int row = 0; row < num_rows; ++row) {
+    for (int col = 0; col < num_cols; ++col, ++idx) {
+      if (col < num_cols - 1) add(idx << 1);
+      if (row < num_rows - 1) add(idx << 1 | 1u);
+    }
+  }
+
+  const auto cols = static_cast<std::uint32_t>(num_cols);
+  for (const std::uint32_t edge : edges) {
+    if (cells.num_sets() == 1) break;
+    const std::uint32_t cell = edge >> 1;
+    const bool south = edge & 1u;
+    if (not cells.unite(cell, south ? cell + cols : cell + 1)) continue;
+    walls.Carve(CarveEvent{static_cast<int>(cell / cols),
+                           static_cast<int>(cell % cols),
+                           south ? Direction::South : Direction::East});
+  }
+  return walls;
+}
+
+outcome::result<SquareRectangularMazeData> GenerateMazeKruskal(
+    int num_cols, int num_rows, const SpanningTreeOptions& options) {
+  return ToMazeData(
+      OUTCOME_TRYX(GenerateKruskalWalls(num_cols, num_rows, options)));
+}
+
+// Each walk overwrites the exit direction of a cell whenever it comes back
+// to it, so following the exits from the start of the walk gives the walk
+// with its loops erased.
+outcome::result<WallPlanes> GenerateWilsonWalls(
+    int num_cols, int num_rows, const SpanningTreeOptions& options) {
+  WallPlanes walls = OUTCOME_TRYX(WallPlanes::Make(num_rows, num_cols));
+  util::BitGrid in_maze =
+      OUTCOME_TRYX(util::BitGrid::Make(num_rows, num_cols, false));
+  std::vector<Direction> exits(static_cast<std::size_t>(num_rows) *
+                               static_cast<std::size_t>(num_cols));
+  util::Xoshiro256 rng{seed_of(options)};
+
+  const auto cell_index = [num_cols](int row, int col) {
+    return static_cast<std::size_t>(row) * static_cast<std::size_t>(num_cols) +
+           static_cast<std::size_t>(col);
+  };
+  const auto visited = [&in_maze](int row, int col) {
+    return in_maze.test_bit(in_maze.bit_index(row, col));
+  };
+
+  in_maze.set_bit(in_maze.bit_index(
+      static_cast<int>(rng.below(static_cast<std::uint32_t>(num_rows))),
+      static_cast<int>(rng.below(static_cast<std::uint32_t>(num_cols)))));
+
+  for (int start_row = 0; start_row < num_rows; ++start_row) {
+    for (int start_col = 0; start_col < num_cols; ++start_col) {
+      if (visited(start_row, start_col)) continue;
+
+      int row = start_row;
+      int col = start_col;
+      while (not visited(row, col)) {
+        const Direction dir = random_direction(
+            rng, inner_directions(row, col, num_rows, num_cols));
+        exits[cell_index(row, col)] = dir;
+        move(row, col, dir);
+      }
+
+      row = start_row;
+      col = start_col;
+      while (not visited(row, col)) {
+        const Direction dir = exits[cell_index(row, col)];
+        in_maze.set_bit(in_maze.bit_index(row, col));
+        walls.Carve(CarveEvent{row, col, dir});
+        move(row, col, dir);
+      }
+    }
+  }
+  return walls;
+}
+
+outcome::result<SquareRectangularMazeData> GenerateMazeWilson(
+    int num_cols, int num_rows, const SpanningTreeOptions& options) {
+  return ToMazeData(
+      OUTCOME_TRYX(GenerateWilsonWalls(num_cols, num_rows, options)));
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <outcome.hpp>
+
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// As for the growing tree, the same seed always produces the same maze and no
+// seed means one from std::random_device.
+struct SpanningTreeOptions {
+  std::optional<std::uint64_t> seed;
+};
+
+// Randomized Kruskal: every inner wall goes into one flat list, which is
+// shuffled in a single pass and then walked once, removing each wall whose
+// cells are not yet connected according to a util::DisjointSets. Gives many
+// short dead ends and an even, grainy texture. Needs 12 bytes per cell while
+// running.
+outcome::result<WallPlanes> GenerateKruskalWalls(
+    int num_cols, int num_rows, const SpanningTreeOptions& options = {});
+
+outcome::result<SquareRectangularMazeData> GenerateMazeKruskal(
+    int num_cols, int num_rows, const SpanningTreeOptions& options = {});
+
+// Wilson's algorithm: loop-erased random walks from every cell not yet in
+// the maze until they hit it. Every spanning tree of the grid is equally
+// likely, which none of the other generators gives. Membership is a bit per
+// cell and each walk only remembers the last direction taken from every
+// cell, so it needs one byte per cell while running; the walks make it the
+// slowest generator.
+outcome::result<WallPlanes> GenerateWilsonWalls(
+    int num_cols, int num_rows, const SpanningTreeOptions& options = {});
+
+outcome::result<SquareRectangularMazeData> GenerateMazeWilson(
+    int num_cols, int num_rows, const SpanningTreeOptions& options = {});
+
+}  // namespace maze_walker
@@ -0,0 +1,79 @@
+#include "mazegen_spanning_tree.hpp"
+
+#include <catch2/catch.hpp>
+#include <functional>
+#include <map>
+
+#include "maze_tree_check.test.hpp"
+
+namespace maze_walker {
+namespace {
+
+using Generator = std::function<outcome::result<SquareRectangularMazeData>(
+    int, int, const SpanningTreeOptions&)>;
+
+Generator generator(bool wilson) {
+  if (wilson) {
+    return [](int cols, int rows, const SpanningTreeOptions& options) {
+      return GenerateMazeWilson(cols, rows, options);
+    };
+  }
+  return [](int cols, int rows, const SpanningTreeOptions& options) {
+    return GenerateMazeKruskal(cols, rows, options);
+  };
+}
+
+}  // namespace
+
+TEST_CASE("Kruskal and Wilson generate perfect mazes",
+          "[maze_spanning_tree]") {
+  const bool wilson = GENERATE(false, true);
+  const auto [cols, rows] = GENERATE(std::pair{1, 1}, std::pair{1, 9},
+                                     std::pair{9, 1}, std::pair{70, 33});
+  SpanningTreeOptions options;
+  options.seed = 12;
+
+  const auto data = generator(wilson)(cols, rows, options).value();
+  REQUIRE(data.num_cols() == cols);
+  REQUIRE(data.num_rows() == rows);
+
+  const TreeCheck check = check_tree(data);
+  REQUIRE(check.symmetric);
+  REQUIRE(check.passages == cols * rows - 1);
+  REQUIRE(check.reachable == cols * rows);
+
+  const auto again = generator(wilson)(cols, rows, options).value();
+  REQUIRE(again.SerializeAsString() == data.SerializeAsString());
+}
+
+TEST_CASE("Spanning tree generators reject empty grids",
+          "[maze_spanning_tree]") {
+  REQUIRE_FALSE(GenerateMazeKruskal(0, 4));
+  REQUIRE_FALSE(GenerateMazeWilson(4, 0));
+}
+
+TEST_CASE("Kruskal rejects grids too large for its 32-bit edges",
+          "[maze_spanning_tree]") {
+  // Rejected up front, without allocating the walls.
+  REQUIRE(GenerateKruskalWalls(1 << 16, 1 << 16).error() ==
+          std::errc::value_too_large);
+}
+
+TEST_CASE("Wilson picks every spanning tree equally often",
+          "[maze_spanning_tree]") {
+  // A 2x2 grid has four spanning trees, one per missing inner wall.
+  std::map<std::string, int> trees;
+  constexpr int kSamples = 4000;
+  SpanningTreeOptions options;
+  for (int i = 0; i < kSamples; ++i) {
+    options.seed = static_cast<std::uint64_t>(i);
+    ++trees[GenerateMazeWilson(2, 2, options).value().SerializeAsString()];
+  }
+  REQUIRE(trees.size() == 4);
+  for (const auto& [tree, count] : trees) {
+    REQUIRE(count > kSamples / 4 - 150);
+    REQUIRE(count < kSamples / 4 + 150);
+  }
+}
+
+}  // namespace maze_walker
@@ -0,0 +1,202 @@
+#include "mazegen_tiled.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "random.hpp"
+
+namespace maze_walker {
+namespace {
+
+constexpr int kBitsPerWord = util::BitGrid::kBitsPerWord;
+
+struct TileLayout {
+  int num_rows;
+  int num_cols;
+  int tile_rows;
+  int tile_cols;
+
+  // Written so that no intermediate value exceeds the maze size, which fits
+  // an int, whatever the tile size.
+  int rows_of_tiles() const { return (num_rows - 1) / tile_rows + 1; }
+  int cols_of_tiles() const { return (num_cols - 1) / tile_cols + 1; }
+  int num_tiles() const { return rows_of_tiles() * cols_of_tiles(); }
+
+  int row_begin(int tile_row) const { return tile_row * tile_rows; }
+  int row_end(int tile_row) const {
+    const int begin = row_begin(tile_row);
+    return begin + std::min(tile_rows, num_rows - begin);
+  }
+  int col_begin(int tile_col) const { return tile_col * tile_cols; }
+  int col_end(int tile_col) const {
+    const int begin = col_begin(tile_col);
+    return begin + std::min(tile_cols, num_cols - begin);
+  }
+};
+
+// Streams derived from the base seed: the tile seeds, the spanning tree over
+// the tiles and the spots where adjacent tiles are joined. Deriving every
+// seed from a hash of the base keeps the mazes of nearby base seeds unrelated.
+constexpr std::uint64_t kTileStream = 0;
+constexpr std::uint64_t kTreeStream = 1;
+constexpr std::uint64_t kJoinStream = 2;
+
+std::uint64_t tile_seed(std::uint64_t base_seed, int tile) {
+  return util::DeriveSeed(util::DeriveSeed(base_seed, kTileStream),
+                          static_cast<std::uint64_t>(tile));
+}
+
+// Tiles start on a word boundary and span whole words (except the last tile
+// of a row, which ends with the row), so rows copy over word for word.
+void copy_tile(const WallPlanes& tile, int row_begin, int col_begin,
+               WallPlanes& walls) {
+  const int first_word = col_begin / kBitsPerWord;
+  const auto words = static_cast<std::size_t>(tile.wall_down.words_per_row());
+  for (int row = 0; row < tile.num_rows(); ++row) {
+    std::copy_n(tile.wall_down.row_words(row), words,
+                walls.wall_down.row_words(row_begin + row) + first_word);
+    std::copy_n(tile.wall_right.row_words(row), words,
+                walls.wall_right.row_words(row_begin + row) + first_word);
+  }
+}
+
+outcome::result<void> carve_tile(const TileLayout& layout, int tile,
+                                 const GrowingTreeOptions& options,
+                                 std::uint64_t base_seed, WallPlanes& walls) {
+  const int tile_row = tile / layout.cols_of_tiles();
+  const int tile_col = tile % layout.cols_of_tiles();
+  const int row_begin = layout.row_begin(tile_row);
+  const int col_begin = layout.col_begin(tile_col);
+
+  GrowingTreeOptions tile_options = options;
+  tile_options.seed = tile_seed(base_seed, tile);
+  GrowingTreeGenerator generator = OUTCOME_TRYX(GrowingTreeGenerator::Make(
+      layout.col_end(tile_col) - col_begin,
+      layout.row_end(tile_row) - row_begin, tile_options));
+  while (generator.Next()) {
+  }
+
+  copy_tile(generator.walls(), row_begin, col_begin, walls);
+  return outcome::success();
+}
+
+outcome::result<void> carve_tiles(const TileLayout& layout,
+                                  const GrowingTreeOptions& options,
+                                  std::uint64_t base_seed, unsigned threads,
+                                  WallPlanes& walls) {
+  std::atomic<int> next_tile{0};
+  std::mutex error_mutex;
+  std::error_code error;
+
+  const auto work = [&] {
+    for (int tile = next_tile++; tile < layout.num_tiles(); tile = next_tile++) {
+      auto carved = carve_tile(layout, tile, options, base_seed, walls);
+      if (not carved) {
+        std::lock_guard lock{error_mutex};
+        error = carved.error();
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (unsigned i = 1; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  if (error) return outcome::failure(error);
+  return outcome::success();
+}
+
+// Carves a random spanning tree over the tile grid and opens one wall at a
+// random spot along the boundary of every pair of tiles it connects.
+outcome::result<void> join_tiles(const TileLayout& layout,
+                                 const GrowingTreeOptions& options,
+                                 std::uint64_t base_seed, WallPlanes& walls) {
+  GrowingTreeOptions tree_options = options;
+  tree_options.seed = util::DeriveSeed(base_seed, kTreeStream);
+  GrowingTreeGenerator tile_tree = OUTCOME_TRYX(GrowingTreeGenerator::Make(
+      layout.cols_of_tiles(), layout.rows_of_tiles(), tree_options));
+
+  util::Xoshiro256 rng{util::DeriveSeed(base_seed, kJoinStream)};
+  const auto random_in = [&rng](int begin, int end) {
+    return begin +
+           static_cast<int>(rng.below(static_cast<std::uint32_t>(end - begin)));
+  };
+
+  while (const auto event = tile_tree.Next()) {
+    int tile_row = event->row;
+    int tile_col = event->col;
+    if (event->direction == Direction::North) tile_row -= 1;
+    if (event->direction == Direction::West) tile_col -= 1;
+
+    if (event->direction == Direction::North ||
+        event->direction == Direction::South) {
+      const int row = layout.row_end(tile_row) - 1;
+      const int col = random_in(layout.col_begin(tile_col),
+                                layout.col_end(tile_col));
+      walls.Carve(CarveEvent{row, col, Direction::South});
+    } else {
+      const int row = random_in(layout.row_begin(tile_row),
+                                layout.row_end(tile_row));
+      const int col = layout.col_end(tile_col) - 1;
+      walls.Carve(CarveEvent{row, col, Direction::East});
+    }
+  }
+
+  return outcome::success();
+}
+
+}  // namespace
+
+outcome::result<WallPlanes> GenerateTiledWalls(int num_cols, int num_rows,
+                                               const TiledOptions& options) {
+  if (options.tile_rows <= 0 || options.tile_cols <= 0) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  WallPlanes walls = OUTCOME_TRYX(WallPlanes::Make(num_rows, num_cols));
+
+  // Tiles larger than the maze are clamped to it before the width is rounded
+  // up to whole words, so a huge tile size cannot overflow the rounding.
+  const int tile_rows = std::min(options.tile_rows, num_rows);
+  const int tile_words =
+      (std::min(options.tile_cols, num_cols) - 1) / kBitsPerWord + 1;
+  const int tile_cols =
+      std::min(tile_words, std::numeric_limits<int>::max() / kBitsPerWord) *
+      kBitsPerWord;
+  const TileLayout layout{num_rows, num_cols, tile_rows, tile_cols};
+
+  const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned threads =
+      std::min(options.threads > 0 ? options.threads : hardware,
+               static_cast<unsigned>(layout.num_tiles()));
+
+  const std::uint64_t base_seed = options.growing_tree.seed
+                                      ? *options.growing_tree.seed
+                                      : util::RandomDeviceSeed();
+
+  OUTCOME_TRYV(
+      carve_tiles(layout, options.growing_tree, base_seed, threads, walls));
+  OUTCOME_TRYV(join_tiles(layout, options.growing_tree, base_seed, walls));
+  return walls;
+}
+
+outcome::result<SquareRectangularMazeData> GenerateMazeTiled(
+    int num_cols, int num_rows, const TiledOptions& options) {
+  return ToMazeData(
+      OUTCOME_TRYX(GenerateTiledWalls(num_cols, num_rows, options)));
+}
+
+}  // namespace maze_walker
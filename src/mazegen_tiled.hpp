@@ -0,0 +1,36 @@
+#pragma once
+
+#include <outcome.hpp>
+
+#include "mazegen_growing_tree.hpp"
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// Options for generating one large maze on several threads. The grid is cut
+// into tiles that are carved independently with the growing tree, then joined
+// into a single perfect maze by opening one wall between each pair of tiles
+// that are adjacent in a random spanning tree of the tile grid.
+//
+// Tile widths are rounded up to a multiple of 64 columns so that no two tiles
+// share a storage word of the wall planes and tiles can be written back
+// without locking. `growing_tree` applies to every tile and to the tile
+// spanning tree; its seed, if set, makes the result independent of the
+// number of threads.
+struct TiledOptions {
+  int tile_rows = 256;
+  int tile_cols = 256;
+  unsigned threads = 0;  // 0 for one per core
+  GrowingTreeOptions growing_tree;
+};
+
+outcome::result<WallPlanes> GenerateTiledWalls(int num_cols, int num_rows,
+                                               const TiledOptions& options);
+
+outcome::result<SquareRectangularMazeData> GenerateMazeTiled(
+    int num_cols, int num_rows, const TiledOptions& options = {});
+
+}  // namespace maze_walker
@@ -0,0 +1,100 @@
+#include "mazegen_tiled.hpp"
+
+#include <catch2/catch.hpp>
+#include <limits>
+
+#include "maze_tree_check.test.hpp"
+
+namespace maze_walker {
+TEST_CASE("Tiled maze is one perfect maze", "[maze_tiled]") {
+  TiledOptions options;
+  options.tile_rows = 7;
+  options.tile_cols = 64;
+  options.threads = 3;
+  options.growing_tree.strategy = GENERATE(SelectionStrategy::Newest,
+                                           SelectionStrategy::Random);
+
+  const SquareRectangularMazeData data =
+      GenerateMazeTiled(150, 30, options).value();
+  REQUIRE(data.num_cols() == 150);
+  REQUIRE(data.num_rows() == 30);
+
+  const int cells = 150 * 30;
+  const TreeCheck check = check_tree(data);
+  REQUIRE(check.symmetric);
+  REQUIRE(check.passages == cells - 1);
+  REQUIRE(check.reachable == cells);
+}
+
+TEST_CASE("Seeded tiled maze does not depend on thread count",
+          "[maze_tiled]") {
+  TiledOptions options;
+  options.tile_rows = 16;
+  options.tile_cols = 16;
+  options.growing_tree.seed = 99;
+
+  options.threads = 1;
+  const auto single = GenerateMazeTiled(200, 40, options).value();
+  options.threads = 4;
+  const auto parallel = GenerateMazeTiled(200, 40, options).value();
+  REQUIRE(single.SerializeAsString() == parallel.SerializeAsString());
+}
+
+TEST_CASE("Nearby seeds give unrelated tiles", "[maze_tiled]") {
+  TiledOptions options;
+  options.tile_rows = 64;
+  options.tile_cols = 64;
+  options.growing_tree.seed = 0;
+  const WallPlanes first = GenerateTiledWalls(128, 64, options).value();
+  options.growing_tree.seed = 1;
+  const WallPlanes second = GenerateTiledWalls(128, 64, options).value();
+
+  // Rows of a tile are one word of each plane. Only the bottom row, where
+  // every south wall is the maze's boundary, is expected to match.
+  const auto matching_rows = [&first, &second](int first_word,
+                                               int second_word) {
+    int matching = 0;
+    for (int row = 0; row < 64; ++row) {
+      matching += first.wall_down.row_words(row)[first_word] ==
+                          second.wall_down.row_words(row)[second_word] &&
+                      first.wall_right.row_words(row)[first_word] ==
+                          second.wall_right.row_words(row)[second_word];
+    }
+    return matching;
+  };
+  for (const int first_tile : {0, 1}) {
+    for (const int second_tile : {0, 1}) {
+      REQUIRE(matching_rows(first_tile, second_tile) <= 1);
+    }
+  }
+}
+
+TEST_CASE("Single tile degenerates to the growing tree", "[maze_tiled]") {
+  TiledOptions options;
+  options.growing_tree.seed = 5;
+  const auto tiled = GenerateMazeTiled(10, 10, options).value();
+  REQUIRE(check_tree(tiled).passages == 10 * 10 - 1);
+
+  options.tile_rows = 0;
+  REQUIRE_FALSE(GenerateMazeTiled(10, 10, options));
+}
+
+TEST_CASE("Tiles larger than the maze are clamped to it", "[maze_tiled]") {
+  static constexpr int kHuge = std::numeric_limits<int>::max();
+  TiledOptions options;
+  options.growing_tree.seed = 5;
+  const auto single = GenerateMazeTiled(90, 20, options).value();
+
+  options.tile_rows = GENERATE(20, kHuge - 1, kHuge);
+  options.tile_cols = GENERATE(90, kHuge - 63, kHuge);
+  options.threads = 2;
+  const auto huge = GenerateMazeTiled(90, 20, options).value();
+  REQUIRE(huge.SerializeAsString() == single.SerializeAsString());
+
+  options.tile_rows = 7;
+  const TreeCheck check =
+      check_tree(GenerateMazeTiled(90, 20, options).value());
+  REQUIRE(check.passages == 90 * 20 - 1);
+  REQUIRE(check.reachable == 90 * 20);
+}
+}  // namespace maze_walker
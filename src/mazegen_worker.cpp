@@ -0,0 +1,62 @@
+#include "mazegen_worker.hpp"
+
+#include <thread>
+#include <utility>
+
+namespace maze_walker {
+
+outcome::result<GenerationWorker> GenerationWorker::Start(
+    int num_cols, int num_rows, const GrowingTreeOptions& options,
+    std::size_t capacity) {
+  GrowingTreeGenerator generator =
+      OUTCOME_TRYX(GrowingTreeGenerator::Make(num_cols, num_rows, options));
+
+  GenerationWorker worker{std::make_unique<Shared>(capacity), num_rows,
+                          num_cols};
+  worker.thread_ = std::thread{[shared = worker.shared_.get(),
+                                generator = std::move(generator)]() mutable {
+    const auto produce = [shared, &generator] {
+      while (const auto event = generator.Next()) {
+        while (not shared->events.try_push(*event)) {
+          if (shared->stop.load(std::memory_order_relaxed)) return;
+          shared->events.wait_for_space();
+        }
+        if (shared->stop.load(std::memory_order_relaxed)) return;
+      }
+      shared->generated.store(true, std::memory_order_release);
+    };
+    produce();
+    shared->exited.store(true, std::memory_order_release);
+  }};
+  return worker;
+}
+
+GenerationWorker& GenerationWorker::operator=(
+    GenerationWorker&& other) noexcept {
+  if (this != &other) {
+    stop();
+    shared_ = std::move(other.shared_);
+    thread_ = std::move(other.thread_);
+    num_rows_ = other.num_rows_;
+    num_cols_ = other.num_cols_;
+  }
+  return *this;
+}
+
+GenerationWorker::~GenerationWorker() { stop(); }
+
+void GenerationWorker::stop() {
+  if (not thread_.joinable()) return;
+  shared_->stop.store(true, std::memory_order_relaxed);
+  // A worker asleep on a full queue only wakes when a slot is freed, and it
+  // may refill the queue and fall asleep again before it sees the flag, so
+  // slots are freed until it has returned.
+  while (not shared_->exited.load(std::memory_order_acquire)) {
+    while (shared_->events.try_pop()) {
+    }
+    std::this_thread::yield();
+  }
+  thread_.join();
+}
+
+}  // namespace maze_walker
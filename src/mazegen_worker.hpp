@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <outcome.hpp>
+#include <thread>
+
+#include "maze_walls.hpp"
+#include "mazegen_growing_tree.hpp"
+#include "spsc_queue.hpp"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// Runs a GrowingTreeGenerator on a thread of its own and hands the carve
+// events to a single consumer thread through a lock-free queue, so the
+// consumer (the render loop) never waits for generation. The worker runs at
+// most `capacity` events ahead and then sleeps until the consumer catches up.
+// Destroying the worker stops and joins the thread.
+class GenerationWorker {
+  struct Shared {
+    explicit Shared(std::size_t capacity) : events{capacity} {}
+
+    util::SpscQueue<CarveEvent> events;
+    std::atomic<bool> generated{false};
+    std::atomic<bool> stop{false};
+    // Set by the thread as it returns, whatever the reason.
+    std::atomic<bool> exited{false};
+  };
+
+  // Heap-allocated so that the thread's view of it survives moves.
+  std::unique_ptr<Shared> shared_;
+  std::thread thread_;
+  int num_rows_;
+  int num_cols_;
+
+  GenerationWorker(std::unique_ptr<Shared> shared, int num_rows, int num_cols)
+      : shared_{std::move(shared)}, num_rows_{num_rows}, num_cols_{num_cols} {}
+
+ public:
+  static outcome::result<GenerationWorker> Start(
+      int num_cols, int num_rows, const GrowingTreeOptions& options = {},
+      std::size_t capacity = 4096);
+
+  GenerationWorker(GenerationWorker&&) noexcept = default;
+  GenerationWorker& operator=(GenerationWorker&& other) noexcept;
+  ~GenerationWorker();
+
+  int num_rows() const { return num_rows_; }
+  int num_cols() const { return num_cols_; }
+
+  // The next carve event, if the worker has produced one yet.
+  std::optional<CarveEvent> Poll() { return shared_->events.try_pop(); }
+
+  // Passes up to `max_carves` ready events to `sink`; returns how many.
+  template <typename Sink>
+  std::size_t Drain(std::size_t max_carves, Sink&& sink) {
+    std::size_t drained = 0;
+    for (; drained < max_carves; ++drained) {
+      const std::optional<CarveEvent> event = Poll();
+      if (not event) break;
+      sink(*event);
+    }
+    return drained;
+  }
+
+  // True once the maze is complete and every event has been consumed.
+  bool finished() const {
+    return shared_->generated.load(std::memory_order_acquire) &&
+           shared_->events.empty();
+  }
+
+ private:
+  void stop();
+};
+
+}  // namespace maze_walker
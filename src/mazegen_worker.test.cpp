@@ -0,0 +1,62 @@
+#include "mazegen_worker.hpp"
+
+#include <catch2/catch.hpp>
+
+#include "maze_tree_check.test.hpp"
+
+namespace maze_walker {
+TEST_CASE("Worker streams the seeded generator's carves", "[maze_worker]") {
+  GrowingTreeOptions options;
+  options.seed = 11;
+  GenerationWorker worker =
+      GenerationWorker::Start(30, 20, options, 16).value();
+  REQUIRE(worker.num_cols() == 30);
+  REQUIRE(worker.num_rows() == 20);
+
+  WallPlanes walls = WallPlanes::Make(20, 30).value();
+  int carves = 0;
+  while (not worker.finished()) {
+    carves += static_cast<int>(worker.Drain(
+        7, [&walls](const CarveEvent& event) { walls.Carve(event); }));
+  }
+  REQUIRE(carves == 30 * 20 - 1);
+  REQUIRE_FALSE(worker.Poll());
+
+  const auto expected = GenerateMaze(30, 20, options).value();
+  REQUIRE(ToMazeData(walls).value().SerializeAsString() ==
+          expected.SerializeAsString());
+  REQUIRE(check_tree(expected).reachable == 30 * 20);
+}
+
+TEST_CASE("Worker stops when destroyed mid-generation", "[maze_worker]") {
+  GenerationWorker worker = GenerationWorker::Start(500, 500, {}, 8).value();
+  while (not worker.Poll()) {
+  }
+  REQUIRE_FALSE(worker.finished());
+
+  // The queue is full long before the maze is done, so the thread has to be
+  // told to stop rather than run to completion.
+  GenerationWorker moved = std::move(worker);
+  while (not moved.Poll()) {
+  }
+  REQUIRE_FALSE(moved.finished());
+}
+
+TEST_CASE("Worker stops whenever it is destroyed", "[maze_worker]") {
+  // With two slots the worker keeps refilling the queue and falling asleep
+  // on it while it is being stopped.
+  for (int run = 0; run < 200; ++run) {
+    GenerationWorker worker = GenerationWorker::Start(64, 64, {}, 2).value();
+    for (int polled = 0; polled < run % 4; ++polled) {
+      worker.Poll();
+    }
+  }
+}
+
+TEST_CASE("Worker rejects invalid options", "[maze_worker]") {
+  GrowingTreeOptions options;
+  options.random_ratio = 2.0;
+  REQUIRE_FALSE(GenerationWorker::Start(10, 10, options));
+  REQUIRE_FALSE(GenerationWorker::Start(0, 10));
+}
+}  // namespace maze_walker
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <bitset>
+#include <outcome.hpp>
+#include <system_error>
+#include <utility>
+
+#include "maze_validate.hpp"
+#include "maze_walls.hpp"
+#include "square_rectangular_maze.pb.h"
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace maze_walker {
+
+// How much SquareRectangularMaze::Make(data) checks of its input.
+enum class MazeValidation {
+  // Positive dimensions and one entry per cell.
+  Dimensions,
+  // Also symmetric walls and a spanning tree, see ValidatePerfectMaze. Use
+  // for mazes loaded from files or received from elsewhere.
+  PerfectMaze,
+};
+
+class SquareRectangularMaze {
+  SquareRectangularMazeData data_;
+
+ public:
+  static outcome::result<SquareRectangularMaze> Make(int num_cols,
+                                                     int num_rows) {
+    SquareRectangularMazeData data;
+    data.set_num_cols(num_cols);
+    data.set_num_rows(num_rows);
+
+    for (int i = 0; i < num_cols * num_rows; ++i) {
+      auto wall = data.add_walls();
+      wall->set_n(false);
+      wall->set_e(false);
+      wall->set_s(false);
+      wall->set_w(false);
+    }
+
+    SquareRectangularMaze maze;
+    maze.data_ = std::move(data);
+    return outcome::success(std::move(maze));
+  }
+
+  static outcome::result<SquareRectangularMaze> Make(
+      SquareRectangularMazeData data,
+      MazeValidation validation = MazeValidation::Dimensions) {
+    if (not HasWallsOfEveryCell(data)) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+    if (validation == MazeValidation::PerfectMaze) {
+      OUTCOME_TRYV(ValidatePerfectMaze(data));
+    }
+
+    SquareRectangularMaze maze;
+    maze.data_ = std::move(data);
+    return outcome::success(std::move(maze));
+  }
+
+  int num_rows() const { return data_.num_rows(); }
+  int num_cols() const { return data_.num_cols(); }
+
+  class ValidPosition {
+    int row_;
+    int col_;
+
+    ValidPosition(int row, int col) : row_{row}, col_{col} {}
+    friend class SquareRectangularMaze;
+
+   public:
+    int row() const { return row_; }
+    int col() const { return col_; }
+  };
+
+  outcome::result<ValidPosition> make_position(int row, int col) const {
+    if (row < 0 || row >= num_rows()) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+
+    if (col < 0 || col >= num_cols()) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+
+    return outcome::success(ValidPosition{row, col});
+  }
+
+  bool has_wall_north(const ValidPosition& pos) const {
+    return walls(pos)[0];
+  }
+
+  bool has_wall_east(const ValidPosition& pos) const {
+    return walls(pos)[1];
+  }
+
+  bool has_wall_south(const ValidPosition& pos) const {
+    return walls(pos)[2];
+  }
+
+  bool has_wall_west(const ValidPosition& pos) const {
+    return walls(pos)[3];
+  }
+
+  // The stored walls of the cell, read once, with the outer boundary closed.
+  std::bitset<4> walls(const ValidPosition& pos) const {
+    WallMask walls = StoredWalls(data_, pos2idx(pos));
+    if (pos.row() == 0) walls |= WallBit(Direction::North);
+    if (pos.col() == num_cols() - 1) walls |= WallBit(Direction::East);
+    if (pos.row() == num_rows() - 1) walls |= WallBit(Direction::South);
+    if (pos.col() == 0) walls |= WallBit(Direction::West);
+    return walls;
+  }
+
+ private:
+  int pos2idx(const ValidPosition& pos) const {
+    return num_cols() * pos.row() + pos.col();
+  }
+};
+
+}  // namespace maze_walker
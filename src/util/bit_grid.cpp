@@ -0,0 +1,45 @@
+#include "bit_grid.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace util {
+
+BitGrid::BitGrid(int num_rows, int num_cols, bool default_value)
+    : num_rows_{num_rows},
+      num_cols_{num_cols},
+      words_per_row_{words_per_row_for(num_cols)},
+      words_(static_cast<size_type>(num_rows_) *
+                 static_cast<size_type>(words_per_row_),
+             Word{0}) {
+  if (default_value) fill(true);
+}
+
+outcome::result<BitGrid> BitGrid::Make(int num_rows, int num_cols,
+                                       bool default_value) {
+  if (num_cols <= 0 || num_rows <= 0) {
+    return outcome::failure(std::errc::invalid_argument);
+  }
+
+  return outcome::success(BitGrid{num_rows, num_cols, default_value});
+}
+
+void BitGrid::fill(bool value) {
+  std::fill(words_.begin(), words_.end(), value ? ~Word{0} : Word{0});
+  if (not value) return;
+
+  const Word last_word_mask = valid_bits(words_per_row_ - 1);
+  for (int row = 0; row < num_rows_; ++row) {
+    row_words(row)[words_per_row_ - 1] &= last_word_mask;
+  }
+}
+
+BitGrid::size_type BitGrid::count() const {
+  size_type total = 0;
+  for (const Word word : words_) {
+    total += static_cast<size_type>(std::popcount(word));
+  }
+  return total;
+}
+
+}  // namespace util
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <outcome.hpp>
+#include <system_error>
+#include <vector>
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace util {
+// Grid of single-bit fields, packed 64 to a word. Storage is row-major and
+// every row starts on a word boundary, so the words of one row can be treated
+// as a bitset. Padding bits past num_cols() are always zero.
+class BitGrid {
+ public:
+  using Word = std::uint64_t;
+  using size_type = std::size_t;
+  static constexpr int kBitsPerWord = 64;
+
+ private:
+  int num_rows_;
+  int num_cols_;
+  int words_per_row_;
+  std::vector<Word> words_;
+
+  BitGrid(int num_rows, int num_cols, bool default_value);
+
+ public:
+  static outcome::result<BitGrid> Make(int num_rows, int num_cols,
+                                       bool default_value = false);
+
+  // Row sizing for a grid `num_cols` wide, computed without overflowing for
+  // any positive int.
+  static constexpr int words_per_row_for(int num_cols) {
+    return static_cast<int>(
+        (static_cast<size_type>(num_cols) + kBitsPerWord - 1) / kBitsPerWord);
+  }
+
+  static constexpr Word valid_bits_for(int num_cols, int word_in_row) {
+    const int valid = num_cols - word_in_row * kBitsPerWord;
+    if (valid >= kBitsPerWord) return ~Word{0};
+    if (valid <= 0) return Word{0};
+    return (Word{1} << valid) - 1;
+  }
+
+  int num_rows() const { return num_rows_; }
+  int num_cols() const { return num_cols_; }
+
+  class Location {
+    int row_;
+    int col_;
+
+    Location(int row, int col) : row_{row}, col_{col} {}
+
+    friend class BitGrid;
+
+   public:
+    int row() const { return row_; }
+    int col() const { return col_; }
+  };
+
+  outcome::result<Location> MakeLocation(int row, int col) const {
+    if (col < 0 || col >= num_cols() || row < 0 || row >= num_rows()) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+    return outcome::success(Location{row, col});
+  }
+
+  bool at(const Location& loc) const {
+    return test_bit(bit_index(loc.row(), loc.col()));
+  }
+
+  void set(const Location& loc, bool value) {
+    const size_type bit = bit_index(loc.row(), loc.col());
+    value ? set_bit(bit) : reset_bit(bit);
+  }
+
+  // Bit-index access for hot loops that derive neighbours arithmetically: the
+  // horizontal neighbours of a bit are +-1 away, the vertical ones
+  // +-row_stride(). No bounds checking.
+  size_type row_stride() const {
+    return static_cast<size_type>(words_per_row_) * kBitsPerWord;
+  }
+
+  size_type bit_index(int row, int col) const {
+    return static_cast<size_type>(row) * row_stride() +
+           static_cast<size_type>(col);
+  }
+
+  bool test_bit(size_type bit) const {
+    return (words_[bit / kBitsPerWord] >> (bit % kBitsPerWord)) & 1u;
+  }
+
+  void set_bit(size_type bit) {
+    words_[bit / kBitsPerWord] |= Word{1} << (bit % kBitsPerWord);
+  }
+
+  void reset_bit(size_type bit) {
+    words_[bit / kBitsPerWord] &= ~(Word{1} << (bit % kBitsPerWord));
+  }
+
+  // Word-level access. Bit `c` of a row lives in word c / 64 at position
+  // c % 64; callers writing whole words must keep the padding bits clear.
+  int words_per_row() const { return words_per_row_; }
+
+  Word* row_words(int row) {
+    return words_.data() + static_cast<size_type>(row) *
+                               static_cast<size_type>(words_per_row_);
+  }
+
+  const Word* row_words(int row) const {
+    return words_.data() + static_cast<size_type>(row) *
+                               static_cast<size_type>(words_per_row_);
+  }
+
+  const std::vector<Word>& words() const { return words_; }
+
+  // Sets every cell to `value`, keeping the storage and the padding clear.
+  void fill(bool value);
+
+  // Mask of the bits of word `word_in_row` that belong to real columns.
+  Word valid_bits(int word_in_row) const {
+    return valid_bits_for(num_cols_, word_in_row);
+  }
+
+  size_type count() const;
+};
+
+}  // namespace util
@@ -0,0 +1,61 @@
+#include "bit_grid.hpp"
+
+#include <catch2/catch.hpp>
+#include <climits>
+
+namespace util {
+TEST_CASE("Instantiating bit grid", "[bit_grid]") {
+  REQUIRE_FALSE(BitGrid::Make(0, 3));
+  REQUIRE_FALSE(BitGrid::Make(3, -1));
+
+  BitGrid g = BitGrid::Make(3, 70).value();
+  REQUIRE(g.num_rows() == 3);
+  REQUIRE(g.num_cols() == 70);
+  REQUIRE(g.words_per_row() == 2);
+  REQUIRE(g.count() == 0);
+
+  SECTION("Accessing elements") {
+    auto location = g.MakeLocation(1, 66).value();
+    REQUIRE_FALSE(g.at(location));
+    g.set(location, true);
+    REQUIRE(g.at(location));
+    REQUIRE(g.row_words(1)[1] == 0b100);
+    REQUIRE(g.count() == 1);
+    g.set(location, false);
+    REQUIRE(g.count() == 0);
+  }
+
+  SECTION("Bit index arithmetic") {
+    const auto bit = g.bit_index(1, 63);
+    g.set_bit(bit + 1);
+    REQUIRE(g.at(g.MakeLocation(1, 64).value()));
+    g.set_bit(bit + g.row_stride());
+    REQUIRE(g.at(g.MakeLocation(2, 63).value()));
+  }
+}
+
+TEST_CASE("Bit grid padding stays clear", "[bit_grid]") {
+  BitGrid g = BitGrid::Make(2, 65, true).value();
+  REQUIRE(g.count() == 2 * 65);
+  REQUIRE(g.valid_bits(0) == ~BitGrid::Word{0});
+  REQUIRE(g.valid_bits(1) == 1);
+  REQUIRE(g.row_words(0)[1] == 1);
+}
+
+TEST_CASE("Bit grid rows up to INT_MAX columns wide", "[bit_grid]") {
+  constexpr BitGrid::Word kAll = ~BitGrid::Word{0};
+
+  STATIC_REQUIRE(BitGrid::words_per_row_for(INT_MAX) == 1 << 25);
+  STATIC_REQUIRE(BitGrid::valid_bits_for(INT_MAX, (1 << 25) - 1) ==
+                 kAll >> 1);
+
+  STATIC_REQUIRE(BitGrid::words_per_row_for(INT_MAX - 63) == (1 << 25) - 1);
+  STATIC_REQUIRE(BitGrid::valid_bits_for(INT_MAX - 63, (1 << 25) - 2) ==
+                 kAll);
+
+  STATIC_REQUIRE(BitGrid::words_per_row_for(65535) == 1024);
+  STATIC_REQUIRE(BitGrid::valid_bits_for(65535, 1023) == kAll >> 1);
+  STATIC_REQUIRE(BitGrid::words_per_row_for(65537) == 1025);
+  STATIC_REQUIRE(BitGrid::valid_bits_for(65537, 1024) == 1);
+}
+}  // namespace util
@@ -0,0 +1,21 @@
+#include "disjoint_sets.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <system_error>
+
+namespace util {
+
+outcome::result<DisjointSets> DisjointSets::Make(std::size_t size) {
+  if (size > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+    return outcome::failure(std::errc::value_too_large);
+  }
+  return DisjointSets{size};
+}
+
+void DisjointSets::reset() {
+  std::fill(parent_.begin(), parent_.end(), -1);
+  num_sets_ = parent_.size();
+}
+
+}  // namespace util
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <outcome.hpp>
+#include <utility>
+#include <vector>
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace util {
+// Union-find over the elements 0 .. size() - 1, in one flat array of 32-bit
+// entries: a non-negative entry is the parent of an element, a negative one
+// marks a root and holds minus the size of its set. Union by size with path
+// halving keeps find() close to constant time without recursion.
+class DisjointSets {
+ public:
+  using index_type = std::uint32_t;
+
+ private:
+  std::vector<std::int32_t> parent_;
+  std::size_t num_sets_;
+
+  explicit DisjointSets(std::size_t size) : parent_(size, -1), num_sets_{size} {}
+
+ public:
+  // Fails for more than 2^31 - 1 elements.
+  static outcome::result<DisjointSets> Make(std::size_t size);
+
+  std::size_t size() const { return parent_.size(); }
+  std::size_t num_sets() const { return num_sets_; }
+
+  // Puts every element back into a set of its own.
+  void reset();
+
+  // Representative of the set holding `x`. No bounds checking.
+  index_type find(index_type x) {
+    while (parent_[x] >= 0) {
+      const auto parent = static_cast<index_type>(parent_[x]);
+      if (parent_[parent] >= 0) parent_[x] = parent_[parent];
+      x = static_cast<index_type>(parent_[x]);
+    }
+    return x;
+  }
+
+  // Merges the sets of `a` and `b`; false if they were already one set.
+  bool unite(index_type a, index_type b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (parent_[a] > parent_[b]) std::swap(a, b);
+    parent_[a] += parent_[b];
+    parent_[b] = static_cast<std::int32_t>(a);
+    --num_sets_;
+    return true;
+  }
+
+  bool same_set(index_type a, index_type b) { return find(a) == find(b); }
+
+  std::size_t set_size(index_type x) {
+    return static_cast<std::size_t>(-parent_[find(x)]);
+  }
+};
+
+}  // namespace util
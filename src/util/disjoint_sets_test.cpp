@@ -0,0 +1,46 @@
+#include "disjoint_sets.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace util {
+TEST_CASE("Uniting disjoint sets", "[disjoint_sets]") {
+  DisjointSets sets = DisjointSets::Make(10).value();
+  REQUIRE(sets.size() == 10);
+  REQUIRE(sets.num_sets() == 10);
+  REQUIRE(sets.find(7) == 7);
+  REQUIRE(sets.set_size(7) == 1);
+
+  REQUIRE(sets.unite(0, 1));
+  REQUIRE(sets.unite(2, 3));
+  REQUIRE(sets.unite(1, 3));
+  REQUIRE_FALSE(sets.unite(0, 2));
+  REQUIRE(sets.num_sets() == 7);
+  REQUIRE(sets.same_set(0, 3));
+  REQUIRE_FALSE(sets.same_set(0, 4));
+  REQUIRE(sets.set_size(2) == 4);
+
+  SECTION("Long chains stay consistent") {
+    for (DisjointSets::index_type i = 4; i < 9; ++i) {
+      REQUIRE(sets.unite(i, i + 1));
+    }
+    REQUIRE(sets.set_size(9) == 6);
+    REQUIRE(sets.unite(9, 0));
+    REQUIRE(sets.num_sets() == 1);
+    for (DisjointSets::index_type i = 0; i < 10; ++i) {
+      REQUIRE(sets.find(i) == sets.find(0));
+    }
+  }
+
+  SECTION("Resetting") {
+    sets.reset();
+    REQUIRE(sets.num_sets() == 10);
+    REQUIRE_FALSE(sets.same_set(0, 1));
+  }
+}
+
+TEST_CASE("Disjoint sets are limited to 32-bit indices", "[disjoint_sets]") {
+  REQUIRE(DisjointSets::Make(0));
+  REQUIRE_FALSE(DisjointSets::Make(std::size_t{1} << 31));
+}
+
+}  // namespace util
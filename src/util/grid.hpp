@@ -1,45 +1,135 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <outcome.hpp>
 #include <system_error>
+#include <type_traits>
 #include <vector>
 
+#include "grid_layout.hpp"
+
 namespace outcome = OUTCOME_V2_NAMESPACE;
 
 namespace util {
-template <typename T>
+
+// Rows/Cols of a Grid whose size is only known at run time.
+inline constexpr int kDynamicExtent = -1;
+
+// Grid of T. Grid<T> is sized at run time and stored in a vector, in the
+// order of `Layout` (grid_layout.hpp); see TiledGrid and MortonGrid.
+// Grid<T, Rows, Cols> has its size in the type, row-major std::array storage
+// and constexpr access, so small grids can be built at compile time.
+template <typename T, int Rows = kDynamicExtent, int Cols = kDynamicExtent,
+          typename Layout = RowMajorLayout>
 class Grid {
+  static_assert(Rows > 0 && Cols > 0, "use Grid<T> for run-time sizes");
+  static_assert(std::is_same_v<Layout, RowMajorLayout>,
+                "fixed-size grids are row-major");
+
+ public:
+  using size_type = std::size_t;
+
+ private:
+  std::array<T, static_cast<size_type>(Rows) * static_cast<size_type>(Cols)>
+      fields_{};
+
+ public:
+  constexpr Grid() = default;
+
+  constexpr explicit Grid(const T& default_value) {
+    for (T& field : fields_) field = default_value;
+  }
+
+  static constexpr int num_rows() { return Rows; }
+  static constexpr int num_cols() { return Cols; }
+
+  class Location {
+    int row_;
+    int col_;
+
+    constexpr Location(int row, int col) : row_{row}, col_{col} {}
+
+    friend class Grid;
+
+   public:
+    constexpr int row() const { return row_; }
+    constexpr int col() const { return col_; }
+  };
+
+  outcome::result<Location> MakeLocation(int row, int col) const {
+    if (col < 0 || col >= Cols || row < 0 || row >= Rows) {
+      return outcome::failure(std::errc::invalid_argument);
+    }
+    return outcome::success(Location{row, col});
+  }
+
+  // Checked at compile time instead.
+  template <int Row, int Col>
+  static constexpr Location MakeLocation() {
+    static_assert(Row >= 0 && Row < Rows && Col >= 0 && Col < Cols,
+                  "location outside the grid");
+    return Location{Row, Col};
+  }
+
+  constexpr T& at(const Location& loc) { return fields_[index_of(loc)]; }
+
+  constexpr const T& at(const Location& loc) const {
+    return fields_[index_of(loc)];
+  }
+
+  // Flat row-major access for loops that derive neighbours arithmetically,
+  // such as the fixed-size maze generator. No bounds checking.
+  static constexpr size_type size() {
+    return static_cast<size_type>(Rows) * static_cast<size_type>(Cols);
+  }
+
+  static constexpr size_type index_of(const Location& loc) {
+    return static_cast<size_type>(loc.row()) * Cols +
+           static_cast<size_type>(loc.col());
+  }
+
+  constexpr T& operator[](size_type idx) { return fields_[idx]; }
+
+  constexpr const T& operator[](size_type idx) const { return fields_[idx]; }
+
+  friend constexpr bool operator==(const Grid&, const Grid&) = default;
+};
+
+template <typename T, typename Layout>
+class Grid<T, kDynamicExtent, kDynamicExtent, Layout> {
   int num_rows_;
   int num_cols_;
+  Layout layout_;
   std::vector<T> fields_;
 
-  using size_type = typename std::vector<T>::size_type;
-
   Grid(int num_rows, int num_cols) : Grid{num_rows, num_cols, T{}} {}
 
   Grid(int num_rows, int num_cols, T&& default_value)
       : num_rows_{num_rows},
         num_cols_{num_cols},
-        fields_(static_cast<size_type>(num_cols_ * num_rows_),
-                std::forward<T>(default_value)) {}
+        layout_{num_rows, num_cols},
+        fields_(layout_.size(), std::forward<T>(default_value)) {}
 
  public:
-  static outcome::result<Grid<T>> Make(int num_rows, int num_cols,
-                                       T&& default_value) {
+  using size_type = typename std::vector<T>::size_type;
+
+  static outcome::result<Grid> Make(int num_rows, int num_cols,
+                                    T&& default_value) {
     if (num_cols <= 0 || num_rows <= 0) {
       return outcome::failure(std::errc::invalid_argument);
     }
 
     return outcome::success(
-        Grid<T>{num_rows, num_cols, std::forward<T>(default_value)});
+        Grid{num_rows, num_cols, std::forward<T>(default_value)});
   }
 
-  static outcome::result<Grid<T>> Make(int num_rows, int num_cols) {
+  static outcome::result<Grid> Make(int num_rows, int num_cols) {
     if (num_cols <= 0 || num_rows <= 0) {
       return outcome::failure(std::errc::invalid_argument);
     }
 
-    return outcome::success(Grid<T>{num_rows, num_cols});
+    return outcome::success(Grid{num_rows, num_cols});
   }
 
   int num_rows() const { return num_rows_; }
@@ -69,10 +159,23 @@ class Grid {
 
   const T& at(const Location& loc) const { return fields_[loc2idx(loc)]; }
 
+  // Flat indices, for sizing per-cell side tables and checking layouts.
+  // Indices follow the layout, and size() includes its padding.
+  size_type size() const { return fields_.size(); }
+
+  size_type index_of(const Location& loc) const { return loc2idx(loc); }
+
  private:
   size_type loc2idx(const Location& loc) const {
-    return static_cast<size_type>(loc.row() * num_cols() + loc.col());
+    return layout_.index(loc.row(), loc.col());
   }
 };
 
+template <typename T, int kTileSide = 8>
+using TiledGrid =
+    Grid<T, kDynamicExtent, kDynamicExtent, TiledLayout<kTileSide>>;
+
+template <typename T>
+using MortonGrid = Grid<T, kDynamicExtent, kDynamicExtent, MortonLayout>;
+
 }  // namespace util
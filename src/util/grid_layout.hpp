@@ -0,0 +1,111 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace util {
+
+// Storage orders for Grid. A layout is built from the grid dimensions and
+// maps every (row, col) inside them to a distinct index in [0, size()); the
+// storage may be padded, so size() can exceed num_rows * num_cols.
+
+// Rows one after the other. Horizontal neighbours are adjacent, vertical ones
+// a whole row apart.
+class RowMajorLayout {
+  std::size_t num_rows_;
+  std::size_t num_cols_;
+
+ public:
+  constexpr RowMajorLayout(int num_rows, int num_cols)
+      : num_rows_{static_cast<std::size_t>(num_rows)},
+        num_cols_{static_cast<std::size_t>(num_cols)} {}
+
+  constexpr std::size_t size() const { return num_rows_ * num_cols_; }
+
+  constexpr std::size_t index(int row, int col) const {
+    return static_cast<std::size_t>(row) * num_cols_ +
+           static_cast<std::size_t>(col);
+  }
+};
+
+// Square tiles of kTileSide x kTileSide cells, row-major inside a tile and
+// tiles row-major in the grid. A cell and its four neighbours usually share
+// a tile, so a vertical step moves kTileSide cells instead of a whole row.
+// The last tile row and column are padded to full tiles.
+template <int kTileSide>
+class TiledLayout {
+  static_assert(kTileSide > 0 && std::has_single_bit(unsigned{kTileSide}),
+                "the tile side must be a power of two");
+  static constexpr int kShift = std::countr_zero(unsigned{kTileSide});
+  static constexpr std::size_t kMask = kTileSide - 1;
+
+  std::size_t tile_rows_;
+  std::size_t tiles_per_row_;
+
+  static constexpr std::size_t tiles(int cells) {
+    return (static_cast<std::size_t>(cells) + kMask) >> kShift;
+  }
+
+ public:
+  constexpr TiledLayout(int num_rows, int num_cols)
+      : tile_rows_{tiles(num_rows)}, tiles_per_row_{tiles(num_cols)} {}
+
+  constexpr std::size_t size() const {
+    return tile_rows_ * tiles_per_row_ << 2 * kShift;
+  }
+
+  constexpr std::size_t index(int row, int col) const {
+    const auto r = static_cast<std::size_t>(row);
+    const auto c = static_cast<std::size_t>(col);
+    const std::size_t tile = (r >> kShift) * tiles_per_row_ + (c >> kShift);
+    return tile << 2 * kShift | (r & kMask) << kShift | (c & kMask);
+  }
+};
+
+// Z-order: the bits of row and col interleaved, so cells close in both
+// directions stay close in memory at every scale. Each dimension is padded
+// to a power of two; once the shorter one runs out of bits, the remaining
+// high bits of the longer one follow, which keeps the padding of a long,
+// thin grid under 4x instead of squaring it.
+class MortonLayout {
+  int row_bits_;
+  int col_bits_;
+  int shared_bits_;
+
+  // Bit i of x moved to bit 2i.
+  static constexpr std::uint64_t spread(std::uint64_t x) {
+    x = (x | x << 16) & 0x0000ffff0000ffffu;
+    x = (x | x << 8) & 0x00ff00ff00ff00ffu;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0fu;
+    x = (x | x << 2) & 0x3333333333333333u;
+    x = (x | x << 1) & 0x5555555555555555u;
+    return x;
+  }
+
+  static constexpr int bits_for(int cells) {
+    return static_cast<int>(
+        std::bit_width(static_cast<unsigned>(cells) - 1u));
+  }
+
+ public:
+  constexpr MortonLayout(int num_rows, int num_cols)
+      : row_bits_{bits_for(num_rows)},
+        col_bits_{bits_for(num_cols)},
+        shared_bits_{row_bits_ < col_bits_ ? row_bits_ : col_bits_} {}
+
+  constexpr std::size_t size() const {
+    return std::size_t{1} << (row_bits_ + col_bits_);
+  }
+
+  constexpr std::size_t index(int row, int col) const {
+    const auto r = static_cast<std::uint64_t>(row);
+    const auto c = static_cast<std::uint64_t>(col);
+    const std::uint64_t low = (std::uint64_t{1} << shared_bits_) - 1;
+    // At most one of the two has bits above the shared ones.
+    const std::uint64_t high = (r | c) >> shared_bits_;
+    return high << 2 * shared_bits_ | spread(r & low) << 1 | spread(c & low);
+  }
+};
+
+}  // namespace util
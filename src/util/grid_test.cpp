@@ -1,6 +1,7 @@
 #include "grid.hpp"
 
 #include <catch2/catch.hpp>
+#include <vector>
 
 namespace util {
 TEST_CASE("Instantiating grid", "[grid]") {
@@ -15,4 +16,65 @@ TEST_CASE("Instantiating grid", "[grid]") {
     REQUIRE(g.at(location) == 10);
   }
 }
+
+TEMPLATE_TEST_CASE("Grid layouts map every cell to its own field", "[grid]",
+                   Grid<int>, TiledGrid<int>, (TiledGrid<int, 16>),
+                   MortonGrid<int>) {
+  const int rows = GENERATE(1, 7, 8, 9, 33);
+  const int cols = GENERATE(1, 5, 16, 70);
+  TestType g = TestType::Make(rows, cols).value();
+  REQUIRE(g.size() >= static_cast<std::size_t>(rows * cols));
+
+  std::vector<bool> used(g.size());
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      const auto location = g.MakeLocation(row, col).value();
+      const auto idx = g.index_of(location);
+      REQUIRE(idx < g.size());
+      REQUIRE_FALSE(used[idx]);
+      used[idx] = true;
+      g.at(location) = row * cols + col;
+    }
+  }
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      REQUIRE(g.at(g.MakeLocation(row, col).value()) == row * cols + col);
+    }
+  }
+}
+
+TEST_CASE("Tiled and Z-order layouts keep neighbours close", "[grid]") {
+  const TiledLayout<8> tiled{64, 1000};
+  REQUIRE(tiled.index(1, 0) - tiled.index(0, 0) == 8);
+  REQUIRE(tiled.index(0, 8) - tiled.index(0, 0) == 64);
+
+  const MortonLayout morton{1000, 1000};
+  REQUIRE(morton.index(0, 1) == 1);
+  REQUIRE(morton.index(1, 0) == 2);
+  REQUIRE(morton.index(1, 1) == 3);
+  REQUIRE(morton.index(2, 2) == 12);
+
+  // A thin grid pads each side to a power of two, not to a square.
+  const MortonLayout thin{4, 1000};
+  REQUIRE(thin.size() == 4 * 1024);
+  REQUIRE(thin.index(3, 999) < thin.size());
+}
+
+TEST_CASE("Fixed-size grid", "[grid]") {
+  Grid<int, 2, 5> g{3};
+  REQUIRE(g.num_rows() == 2);
+  REQUIRE(g.num_cols() == 5);
+  REQUIRE(g.size() == 10);
+
+  SECTION("Locations are checked like in the dynamic grid") {
+    REQUIRE_FALSE(g.MakeLocation(2, 0));
+    REQUIRE_FALSE(g.MakeLocation(0, 5));
+    REQUIRE_FALSE(g.MakeLocation(-1, 0));
+    const auto location = g.MakeLocation(1, 4).value();
+    REQUIRE(g.at(location) == 3);
+    g.at(location) = 10;
+    REQUIRE(g[g.index_of(location)] == 10);
+    REQUIRE(g.index_of(location) == g.index_of(g.MakeLocation<1, 4>()));
+  }
+}
 }  // namespace util
@@ -0,0 +1,106 @@
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UTIL_HAS_MMAP 1
+#else
+#define UTIL_HAS_MMAP 0
+#endif
+
+namespace util {
+namespace {
+
+outcome::result<std::vector<std::uint64_t>> read_whole_file(
+    const std::filesystem::path& path, std::size_t& size) {
+  std::ifstream in{path, std::ios::binary | std::ios::ate};
+  if (not in) {
+    return outcome::failure(std::errc::no_such_file_or_directory);
+  }
+  size = static_cast<std::size_t>(in.tellg());
+  std::vector<std::uint64_t> buffer((size + 7) / 8);
+  in.seekg(0);
+  if (not in.read(reinterpret_cast<char*>(buffer.data()),
+                  static_cast<std::streamsize>(size))) {
+    return outcome::failure(std::errc::io_error);
+  }
+  return buffer;
+}
+
+#if UTIL_HAS_MMAP
+std::error_code last_error() { return {errno, std::generic_category()}; }
+#endif
+
+}  // namespace
+
+outcome::result<MappedFile> MappedFile::Open(
+    const std::filesystem::path& path) {
+  MappedFile file;
+
+#if UTIL_HAS_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return outcome::failure(last_error());
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    const auto error = last_error();
+    ::close(fd);
+    return outcome::failure(error);
+  }
+
+  // Empty files cannot be mapped; there is nothing to read anyway.
+  file.size_ = static_cast<std::size_t>(info.st_size);
+  if (file.size_ > 0) {
+    void* addr = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      file.data_ = static_cast<const std::byte*>(addr);
+      file.mapped_ = true;
+    }
+  }
+  ::close(fd);
+  if (file.mapped_ || file.size_ == 0) return file;
+#endif
+
+  file.buffer_ = OUTCOME_TRYX(read_whole_file(path, file.size_));
+  file.data_ = reinterpret_cast<const std::byte*>(file.buffer_.data());
+  return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)},
+      mapped_{std::exchange(other.mapped_, false)},
+      buffer_{std::move(other.buffer_)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    reset();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mapped_ = std::exchange(other.mapped_, false);
+    buffer_ = std::move(other.buffer_);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { reset(); }
+
+void MappedFile::reset() {
+#if UTIL_HAS_MMAP
+  if (mapped_) {
+    ::munmap(const_cast<std::byte*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  buffer_.clear();
+}
+
+}  // namespace util
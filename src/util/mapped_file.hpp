@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <outcome.hpp>
+#include <span>
+#include <vector>
+
+namespace outcome = OUTCOME_V2_NAMESPACE;
+
+namespace util {
+// Read-only contents of a whole file. Where mmap is available the file is
+// mapped, so opening is O(1) and pages are only read when first touched;
+// elsewhere it is read into memory. Either way the bytes start on an 8-byte
+// boundary.
+class MappedFile {
+  const std::byte* data_ = nullptr;
+  std::size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<std::uint64_t> buffer_;
+
+  MappedFile() = default;
+
+ public:
+  static outcome::result<MappedFile> Open(const std::filesystem::path& path);
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  std::span<const std::byte> bytes() const { return {data_, size_}; }
+  bool mapped() const { return mapped_; }
+
+ private:
+  void reset();
+};
+
+}  // namespace util
@@ -0,0 +1,38 @@
+#include "mapped_file.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace util {
+TEST_CASE("Mapping a file", "[mapped_file]") {
+  const auto path =
+      std::filesystem::temp_directory_path() / "mapped_file_test.bin";
+  {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out << "maze walker";
+  }
+
+  MappedFile file = MappedFile::Open(path).value();
+  REQUIRE(file.bytes().size() == 11);
+  REQUIRE(std::memcmp(file.bytes().data(), "maze walker", 11) == 0);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(file.bytes().data()) % 8 == 0);
+
+  SECTION("Moving keeps the contents") {
+    const auto* data = file.bytes().data();
+    MappedFile moved = std::move(file);
+    REQUIRE(moved.bytes().data() == data);
+    REQUIRE(moved.bytes().size() == 11);
+  }
+
+  SECTION("Empty file") {
+    std::ofstream{path, std::ios::binary | std::ios::trunc}.close();
+    REQUIRE(MappedFile::Open(path).value().bytes().empty());
+  }
+
+  std::filesystem::remove(path);
+  REQUIRE_FALSE(MappedFile::Open(path));
+}
+}  // namespace util
@@ -0,0 +1,98 @@
+#include "profile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+namespace util {
+namespace {
+
+// Sites are only ever added, and live until the end of the program.
+struct Registry {
+  std::mutex mutex;
+  std::vector<ProfilePoint*> points;
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+}  // namespace
+
+ProfilePoint::ProfilePoint(std::string_view name, ProfileKind kind)
+    : name_{name}, kind_{kind} {
+  Registry& points = registry();
+  const std::lock_guard lock{points.mutex};
+  points.points.push_back(this);
+}
+
+std::vector<ProfileEntry> ProfileSnapshot() {
+  Registry& points = registry();
+  std::vector<ProfileEntry> entries;
+  {
+    const std::lock_guard lock{points.mutex};
+    entries.reserve(points.points.size());
+    for (const ProfilePoint* point : points.points) {
+      entries.push_back(
+          {point->name(), point->kind(), point->calls(), point->value()});
+    }
+  }
+
+  // Sites sharing a name (the same macro in an inline function, say) are
+  // reported as one.
+  std::sort(entries.begin(), entries.end(),
+            [](const ProfileEntry& a, const ProfileEntry& b) {
+              return a.name < b.name;
+            });
+  std::vector<ProfileEntry> merged;
+  for (const ProfileEntry& entry : entries) {
+    if (merged.empty() || merged.back().name != entry.name) {
+      merged.push_back(entry);
+      continue;
+    }
+    ProfileEntry& into = merged.back();
+    into.calls += entry.calls;
+    into.value = entry.kind == ProfileKind::Peak
+                     ? std::max(into.value, entry.value)
+                     : into.value + entry.value;
+  }
+  return merged;
+}
+
+std::string FormatProfileEntry(const ProfileEntry& entry) {
+  char buffer[128] = {};
+  const std::string name{entry.name};
+  switch (entry.kind) {
+    case ProfileKind::Timer: {
+      const double ms = static_cast<double>(entry.value) * 1e-6;
+      const double us_each =
+          entry.calls == 0 ? 0.0
+                           : static_cast<double>(entry.value) * 1e-3 /
+                                 static_cast<double>(entry.calls);
+      std::snprintf(buffer, sizeof(buffer),
+                    "%s: %llu calls, %.3f ms, %.3f us each", name.c_str(),
+                    static_cast<unsigned long long>(entry.calls), ms, us_each);
+      break;
+    }
+    case ProfileKind::Counter:
+      std::snprintf(buffer, sizeof(buffer), "%s: %llu", name.c_str(),
+                    static_cast<unsigned long long>(entry.value));
+      break;
+    case ProfileKind::Peak:
+      std::snprintf(buffer, sizeof(buffer), "%s: peak %llu", name.c_str(),
+                    static_cast<unsigned long long>(entry.value));
+      break;
+  }
+  return buffer;
+}
+
+void ResetProfile() {
+  Registry& points = registry();
+  const std::lock_guard lock{points.mutex};
+  for (ProfilePoint* point : points.points) {
+    point->Reset();
+  }
+}
+
+}  // namespace util
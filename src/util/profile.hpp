@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Scoped timers and counters for the hot paths. They are compiled in only
+// with MAZE_WALKER_PROFILING defined (the ENABLE_PROFILING CMake option);
+// otherwise every MAZE_PROFILE_* macro expands to nothing and its arguments
+// are not evaluated.
+//
+//   MAZE_PROFILE_SCOPE("phase");          // time until the end of the scope
+//   MAZE_PROFILE_COUNT("counter", n);     // add n
+//   MAZE_PROFILE_PEAK("counter", value);  // keep the largest value seen
+//
+// Names are string literals; every use of a name must be of the same kind.
+// Updates are relaxed atomic adds, so the macros can be used from any thread,
+// and ProfileSnapshot() reads the totals at any time.
+
+namespace util {
+
+#ifdef MAZE_WALKER_PROFILING
+inline constexpr bool kProfilingEnabled = true;
+#else
+inline constexpr bool kProfilingEnabled = false;
+#endif
+
+enum class ProfileKind {
+  Timer,
+  Counter,
+  Peak,
+};
+
+// One timer or counter site. The macros declare them as function-local
+// statics, so a site registers itself the first time it runs.
+class ProfilePoint {
+  std::string_view name_;
+  ProfileKind kind_;
+  std::atomic<std::uint64_t> calls_{0};
+  std::atomic<std::uint64_t> value_{0};
+
+ public:
+  ProfilePoint(std::string_view name, ProfileKind kind);
+  ProfilePoint(const ProfilePoint&) = delete;
+  ProfilePoint& operator=(const ProfilePoint&) = delete;
+
+  std::string_view name() const { return name_; }
+  ProfileKind kind() const { return kind_; }
+  std::uint64_t calls() const {
+    return calls_.load(std::memory_order_relaxed);
+  }
+  std::uint64_t value() const {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+  void Reset() {
+    calls_.store(0, std::memory_order_relaxed);
+    value_.store(0, std::memory_order_relaxed);
+  }
+
+  void Add(std::uint64_t amount) {
+    calls_.fetch_add(1, std::memory_order_relaxed);
+    value_.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  void Peak(std::uint64_t value) {
+    calls_.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t peak = value_.load(std::memory_order_relaxed);
+    while (value > peak && not value_.compare_exchange_weak(
+                               peak, value, std::memory_order_relaxed)) {
+    }
+  }
+};
+
+// Adds the nanoseconds between construction and destruction to a timer.
+class ScopedTimer {
+  ProfilePoint& point_;
+  std::chrono::steady_clock::time_point start_;
+
+ public:
+  explicit ScopedTimer(ProfilePoint& point)
+      : point_{point}, start_{std::chrono::steady_clock::now()} {}
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  ~ScopedTimer() {
+    const auto elapsed = std::chrono::steady_clock::now() - start_;
+    point_.Add(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+            .count()));
+  }
+};
+
+struct ProfileEntry {
+  std::string_view name;
+  ProfileKind kind;
+  // Scopes exited for a timer, updates for a counter or peak.
+  std::uint64_t calls;
+  // Total nanoseconds for a timer, the sum for a counter, the maximum for a
+  // peak.
+  std::uint64_t value;
+};
+
+// Every site that has run so far, sorted by name. Empty when profiling is
+// compiled out.
+std::vector<ProfileEntry> ProfileSnapshot();
+
+// Zeroes every site; sites keep their registration.
+void ResetProfile();
+
+// Widens a macro argument to the counter type. A function template rather
+// than a cast in the macro, which would be a useless cast whenever the
+// argument already is a std::uint64_t.
+template <std::integral T>
+constexpr std::uint64_t profile_amount(T amount) {
+  return static_cast<std::uint64_t>(amount);
+}
+
+// One line for logs, e.g. "render.draw: 120 calls, 15.300 ms, 127.500 us
+// each" or "growing_tree.steps: 8191".
+std::string FormatProfileEntry(const ProfileEntry& entry);
+
+}  // namespace util
+
+#define MAZE_PROFILE_CAT_(a, b) a##b
+#define MAZE_PROFILE_CAT(a, b) MAZE_PROFILE_CAT_(a, b)
+#define MAZE_PROFILE_POINT_ MAZE_PROFILE_CAT(maze_profile_point_, __LINE__)
+#define MAZE_PROFILE_TIMER_ MAZE_PROFILE_CAT(maze_profile_timer_, __LINE__)
+
+#ifdef MAZE_WALKER_PROFILING
+#define MAZE_PROFILE_SCOPE(name)                                          \
+  static ::util::ProfilePoint MAZE_PROFILE_POINT_{                        \
+      name, ::util::ProfileKind::Timer};                                  \
+  const ::util::ScopedTimer MAZE_PROFILE_TIMER_ { MAZE_PROFILE_POINT_ }
+#define MAZE_PROFILE_COUNT(name, amount)                                  \
+  do {                                                                    \
+    const auto maze_profile_amount = ::util::profile_amount(amount);      \
+    static ::util::ProfilePoint maze_profile_point{                       \
+        name, ::util::ProfileKind::Counter};                              \
+    maze_profile_point.Add(maze_profile_amount);                          \
+  } while (false)
+#define MAZE_PROFILE_PEAK(name, value)                                    \
+  do {                                                                    \
+    const auto maze_profile_value = ::util::profile_amount(value);        \
+    static ::util::ProfilePoint maze_profile_point{                       \
+        name, ::util::ProfileKind::Peak};                                 \
+    maze_profile_point.Peak(maze_profile_value);                          \
+  } while (false)
+#else
+#define MAZE_PROFILE_SCOPE(name) static_cast<void>(0)
+#define MAZE_PROFILE_COUNT(name, amount) static_cast<void>(0)
+#define MAZE_PROFILE_PEAK(name, value) static_cast<void>(0)
+#endif
@@ -0,0 +1,94 @@
+#include "profile.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <optional>
+#include <thread>
+
+namespace util {
+namespace {
+
+std::optional<ProfileEntry> find_entry(std::string_view name) {
+  const auto entries = ProfileSnapshot();
+  const auto it = std::find_if(
+      entries.begin(), entries.end(),
+      [name](const ProfileEntry& entry) { return entry.name == name; });
+  if (it == entries.end()) return std::nullopt;
+  return *it;
+}
+
+}  // namespace
+
+TEST_CASE("Profile points accumulate and merge by name", "[profile]") {
+  static ProfilePoint counter{"test.counter", ProfileKind::Counter};
+  static ProfilePoint same_name{"test.counter", ProfileKind::Counter};
+  static ProfilePoint peak{"test.peak", ProfileKind::Peak};
+  ResetProfile();
+
+  counter.Add(3);
+  counter.Add(4);
+  same_name.Add(5);
+  peak.Peak(7);
+  peak.Peak(2);
+
+  const auto counted = find_entry("test.counter");
+  REQUIRE(counted);
+  REQUIRE(counted->calls == 3);
+  REQUIRE(counted->value == 12);
+
+  const auto peaked = find_entry("test.peak");
+  REQUIRE(peaked);
+  REQUIRE(peaked->kind == ProfileKind::Peak);
+  REQUIRE(peaked->value == 7);
+
+  REQUIRE(FormatProfileEntry(*counted) == "test.counter: 12");
+  REQUIRE(FormatProfileEntry(*peaked) == "test.peak: peak 7");
+  REQUIRE(FormatProfileEntry({"test.timer", ProfileKind::Timer, 4, 2000000}) ==
+          "test.timer: 4 calls, 2.000 ms, 500.000 us each");
+
+  ResetProfile();
+  REQUIRE(find_entry("test.counter")->value == 0);
+  REQUIRE(find_entry("test.peak")->calls == 0);
+}
+
+TEST_CASE("Profile counters can be updated from several threads",
+          "[profile]") {
+  static ProfilePoint counter{"test.threads", ProfileKind::Counter};
+  ResetProfile();
+
+  constexpr int kPerThread = 10000;
+  std::thread other{[] {
+    for (int i = 0; i < kPerThread; ++i) counter.Add(1);
+  }};
+  for (int i = 0; i < kPerThread; ++i) counter.Add(1);
+  other.join();
+
+  REQUIRE(find_entry("test.threads")->value == 2 * kPerThread);
+}
+
+TEST_CASE("Profile macros compile out unless enabled", "[profile]") {
+  ResetProfile();
+  int evaluated = 0;
+  {
+    MAZE_PROFILE_SCOPE("test.macro_scope");
+    MAZE_PROFILE_COUNT("test.macro_count", ++evaluated);
+    MAZE_PROFILE_PEAK("test.macro_peak", 9);
+  }
+
+  const auto scope = find_entry("test.macro_scope");
+  const auto count = find_entry("test.macro_count");
+  const auto peak = find_entry("test.macro_peak");
+  if constexpr (kProfilingEnabled) {
+    REQUIRE(evaluated == 1);
+    REQUIRE(scope->calls == 1);
+    REQUIRE(count->value == 1);
+    REQUIRE(peak->value == 9);
+  } else {
+    REQUIRE(evaluated == 0);
+    REQUIRE_FALSE(scope);
+    REQUIRE_FALSE(count);
+    REQUIRE_FALSE(peak);
+  }
+}
+
+}  // namespace util
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace util {
+
+// SplitMix64, used to expand a single 64-bit seed into engine state.
+class SplitMix64 {
+  std::uint64_t state_;
+
+ public:
+  constexpr explicit SplitMix64(std::uint64_t seed) : state_{seed} {}
+
+  constexpr std::uint64_t operator()() {
+    std::uint64_t z = (state_ += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+};
+
+// Seed of stream `index` derived from `seed`, for runs that need many
+// independent generators from one seed. The seed is hashed before the index
+// is mixed in: with seed + index, stream i of seed s would be stream i - 1
+// of seed s + 1.
+constexpr std::uint64_t DeriveSeed(std::uint64_t seed, std::uint64_t index) {
+  return SplitMix64{SplitMix64{seed}() + index}();
+}
+
+// xoshiro256** by Blackman and Vigna: 32 bytes of state, a handful of
+// shifts and rotates per draw, and good statistical quality. Meets the
+// UniformRandomBitGenerator requirements, so it also plugs into <random>
+// and <algorithm>. Everything is constexpr so seeded generation can run at
+// compile time.
+class Xoshiro256 {
+  std::uint64_t s_[4];
+
+  static constexpr std::uint64_t rotl(std::uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+ public:
+  using result_type = std::uint64_t;
+
+  constexpr explicit Xoshiro256(std::uint64_t seed) : s_{} {
+    SplitMix64 expand{seed};
+    for (auto& word : s_) word = expand();
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() {
+    const std::uint64_t result = rotl(s_[1] * 5, 7) * 9;
+    const std::uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  // Uniform draw from [0, bound) using Lemire's multiply-shift method; the
+  // rejection branch is taken with probability below bound / 2^32, so for
+  // the small bounds of maze generation it is effectively one multiply.
+  constexpr std::uint32_t below(std::uint32_t bound) {
+    auto product = (operator()() >> 32) * bound;
+    auto low = static_cast<std::uint32_t>(product);
+    if (low < bound) {
+      const std::uint32_t threshold = -bound % bound;
+      while (low < threshold) {
+        product = (operator()() >> 32) * bound;
+        low = static_cast<std::uint32_t>(product);
+      }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+  }
+
+  // True with the given probability, from the top 53 bits of one draw.
+  constexpr bool chance(double probability) {
+    constexpr double scale = 1.0 / static_cast<double>(std::uint64_t{1} << 53);
+    return static_cast<double>(operator()() >> 11) * scale < probability;
+  }
+};
+
+// 64 bits of seed from std::random_device, for callers that were not given
+// one.
+inline std::uint64_t RandomDeviceSeed() {
+  std::random_device device;
+  return std::uint64_t{device()} << 32 | device();
+}
+
+}  // namespace util
@@ -0,0 +1,53 @@
+#include "random.hpp"
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <set>
+
+namespace util {
+TEST_CASE("SplitMix64 matches the reference output", "[random]") {
+  SplitMix64 gen{0};
+  REQUIRE(gen() == 0xe220a8397b1dcdafu);
+}
+
+TEST_CASE("Derived seeds of adjacent seeds do not overlap", "[random]") {
+  std::set<std::uint64_t> seen;
+  for (std::uint64_t seed = 0; seed < 16; ++seed) {
+    for (std::uint64_t index = 0; index < 256; ++index) {
+      REQUIRE(seen.insert(DeriveSeed(seed, index)).second);
+    }
+  }
+}
+
+TEST_CASE("Xoshiro256 is deterministic for a seed", "[random]") {
+  Xoshiro256 gen{42};
+  REQUIRE(gen() == 0x15780b2e0c2ec716u);
+  REQUIRE(gen() == 0x6104d9866d113a7eu);
+  REQUIRE(gen() == 0xae17533239e499a1u);
+
+  Xoshiro256 a{7};
+  Xoshiro256 b{7};
+  Xoshiro256 c{8};
+  const auto first = a();
+  REQUIRE(first == b());
+  REQUIRE(first != c());
+}
+
+TEST_CASE("Bounded draws stay in range and cover it", "[random]") {
+  Xoshiro256 gen{1};
+  std::array<int, 3> hits{};
+  for (int i = 0; i < 3000; ++i) {
+    const auto value = gen.below(3);
+    REQUIRE(value < 3);
+    ++hits[value];
+  }
+  for (const int count : hits) {
+    REQUIRE(count > 800);
+  }
+
+  REQUIRE(gen.below(1) == 0);
+  REQUIRE_FALSE(gen.chance(0.0));
+  REQUIRE(gen.chance(1.0));
+}
+}  // namespace util
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace util {
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. try_push() and wait_for_space() may only be called from the
+// producer and try_pop() only from the consumer; only wait_for_space() ever
+// blocks. The two indices live on separate
+// cache lines, and each side keeps a cached copy of the other's index so that
+// it only touches the shared line when the queue looks full (or empty).
+template <typename T>
+class SpscQueue {
+  static constexpr std::size_t kCacheLine = 64;
+
+  std::vector<T> slots_;
+  std::size_t mask_;
+
+  // Written by the consumer: next slot to pop.
+  alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+  std::size_t cached_tail_ = 0;
+
+  // Written by the producer: next slot to push.
+  alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+  std::size_t cached_head_ = 0;
+
+ public:
+  // Capacity is rounded up to a power of two, and at least 2.
+  explicit SpscQueue(std::size_t min_capacity)
+      : slots_(std::bit_ceil(min_capacity < 2 ? 2 : min_capacity)),
+        mask_{slots_.size() - 1} {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  std::size_t capacity() const { return slots_.size(); }
+
+  bool try_push(const T& value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == slots_.size()) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ == slots_.size()) return false;
+    }
+    slots_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Sleeps until the queue is not full. A pop wakes the producer, so it does
+  // not spin or poll while the consumer is idle.
+  void wait_for_space() {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    std::size_t head = head_.load(std::memory_order_acquire);
+    while (tail - head == slots_.size()) {
+      head_.wait(head, std::memory_order_acquire);
+      head = head_.load(std::memory_order_acquire);
+    }
+    cached_head_ = head;
+  }
+
+  std::optional<T> try_pop() {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) return std::nullopt;
+    }
+    std::optional<T> value{std::move(slots_[head & mask_])};
+    head_.store(head + 1, std::memory_order_release);
+    head_.notify_one();
+    return value;
+  }
+
+  // Only exact when called from one of the two threads while the other is
+  // idle; otherwise a snapshot.
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+};
+
+}  // namespace util
@@ -0,0 +1,75 @@
+#include "spsc_queue.hpp"
+
+#include <catch2/catch.hpp>
+#include <thread>
+
+namespace util {
+TEST_CASE("Queue is first in, first out and bounded", "[spsc_queue]") {
+  SpscQueue<int> queue{3};
+  REQUIRE(queue.capacity() == 4);
+  REQUIRE(queue.empty());
+  REQUIRE_FALSE(queue.try_pop());
+
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(queue.try_push(i));
+  }
+  REQUIRE_FALSE(queue.try_push(4));
+
+  REQUIRE(queue.try_pop() == 0);
+  REQUIRE(queue.try_push(4));
+  for (int i = 1; i <= 4; ++i) {
+    REQUIRE(queue.try_pop() == i);
+  }
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("Queue hands values across threads in order", "[spsc_queue]") {
+  constexpr int kCount = 200000;
+  SpscQueue<int> queue{64};
+
+  std::thread producer{[&queue] {
+    for (int i = 0; i < kCount;) {
+      if (queue.try_push(i)) ++i;
+    }
+  }};
+
+  int expected = 0;
+  bool in_order = true;
+  while (expected < kCount) {
+    if (const auto value = queue.try_pop()) {
+      in_order &= *value == expected;
+      ++expected;
+    }
+  }
+  producer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("Producer sleeps on a full queue until a pop", "[spsc_queue]") {
+  constexpr int kCount = 20000;
+  SpscQueue<int> queue{4};
+
+  std::thread producer{[&queue] {
+    for (int i = 0; i < kCount; ++i) {
+      while (not queue.try_push(i)) queue.wait_for_space();
+    }
+  }};
+
+  int expected = 0;
+  bool in_order = true;
+  while (expected < kCount) {
+    if (const auto value = queue.try_pop()) {
+      in_order &= *value == expected;
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(queue.empty());
+}
+}  // namespace util
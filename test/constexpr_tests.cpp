@@ -1,4 +1,9 @@
+#include <array>
 #include <catch2/catch.hpp>
+#include <cstddef>
+
+#include "grid.hpp"
+#include "mazegen_fixed.hpp"
 
 constexpr unsigned int Factorial(unsigned int number)
 {
@@ -12,3 +17,109 @@ TEST_CASE("Factorials are computed with constexpr", "[factorial]")
   STATIC_REQUIRE(Factorial(3) == 6);
   STATIC_REQUIRE(Factorial(10) == 3628800);
 }
+
+namespace {
+
+using maze_walker::Direction;
+using maze_walker::FixedMaze;
+using maze_walker::GenerateFixedMaze;
+using maze_walker::WallBit;
+
+template <int Rows, int Cols>
+constexpr bool has_wall(const FixedMaze<Rows, Cols>& maze, int row, int col,
+                        Direction dir) {
+  return maze[static_cast<std::size_t>(row * Cols + col)] & WallBit(dir);
+}
+
+// Closed boundary, every inner wall seen the same from both sides, one
+// passage fewer than cells and every cell reachable from the first: a
+// spanning tree of the grid.
+template <int Rows, int Cols>
+constexpr bool is_perfect(const FixedMaze<Rows, Cols>& maze) {
+  int passages = 0;
+  for (int row = 0; row < Rows; ++row) {
+    for (int col = 0; col < Cols; ++col) {
+      const auto wall = [&](Direction dir) {
+        return has_wall(maze, row, col, dir);
+      };
+      if ((row == 0 && not wall(Direction::North)) ||
+          (col == 0 && not wall(Direction::West)) ||
+          (row + 1 == Rows && not wall(Direction::South)) ||
+          (col + 1 == Cols && not wall(Direction::East))) {
+        return false;
+      }
+      if (row + 1 < Rows) {
+        const bool south = wall(Direction::South);
+        if (south != has_wall(maze, row + 1, col, Direction::North)) {
+          return false;
+        }
+        passages += south ? 0 : 1;
+      }
+      if (col + 1 < Cols) {
+        const bool east = wall(Direction::East);
+        if (east != has_wall(maze, row, col + 1, Direction::West)) {
+          return false;
+        }
+        passages += east ? 0 : 1;
+      }
+    }
+  }
+  if (passages != Rows * Cols - 1) return false;
+
+  constexpr auto kCells = static_cast<std::size_t>(Rows * Cols);
+  std::array<bool, kCells> reached{};
+  std::array<int, kCells> stack{};
+  std::size_t top = 0;
+  std::size_t num_reached = 1;
+  reached[0] = true;
+  stack[top++] = 0;
+  while (top > 0) {
+    const int cell = stack[--top];
+    const int row = cell / Cols;
+    const int col = cell % Cols;
+    const auto visit = [&](Direction dir, int next) {
+      if (has_wall(maze, row, col, dir)) return;
+      const auto idx = static_cast<std::size_t>(next);
+      if (reached[idx]) return;
+      reached[idx] = true;
+      ++num_reached;
+      stack[top++] = next;
+    };
+    visit(Direction::North, cell - Cols);
+    visit(Direction::East, cell + 1);
+    visit(Direction::South, cell + Cols);
+    visit(Direction::West, cell - 1);
+  }
+  return num_reached == kCells;
+}
+
+// Baked into the binary; nothing is generated at run time.
+constexpr auto kLevel = GenerateFixedMaze<9, 13>(2024);
+
+}  // namespace
+
+TEST_CASE("Fixed-size grids are usable in constant expressions", "[grid]") {
+  using SmallGrid = util::Grid<int, 3, 4>;
+  constexpr SmallGrid grid = [] {
+    SmallGrid g{7};
+    g.at(SmallGrid::MakeLocation<2, 3>()) = 11;
+    return g;
+  }();
+  STATIC_REQUIRE(grid.num_rows() == 3);
+  STATIC_REQUIRE(grid.num_cols() == 4);
+  STATIC_REQUIRE(grid.size() == 12);
+  STATIC_REQUIRE(grid[0] == 7);
+  STATIC_REQUIRE(grid[11] == 11);
+  STATIC_REQUIRE(SmallGrid::index_of(SmallGrid::MakeLocation<1, 2>()) == 6);
+}
+
+TEST_CASE("Seeded mazes are generated at compile time", "[mazegen_fixed]") {
+  STATIC_REQUIRE(is_perfect(kLevel));
+  STATIC_REQUIRE(is_perfect(GenerateFixedMaze<1, 1>(0)));
+  STATIC_REQUIRE(is_perfect(GenerateFixedMaze<1, 16>(3)));
+  STATIC_REQUIRE(is_perfect(GenerateFixedMaze<16, 1>(3)));
+  STATIC_REQUIRE(is_perfect(GenerateFixedMaze<16, 16>(99)));
+
+  STATIC_REQUIRE(GenerateFixedMaze<8, 8>(5) == GenerateFixedMaze<8, 8>(5));
+  STATIC_REQUIRE(GenerateFixedMaze<8, 8>(5) != GenerateFixedMaze<8, 8>(6));
+}